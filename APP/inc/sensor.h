@@ -10,21 +10,161 @@
 #include <stdint.h>
 #include <string.h>
 
+// Compact handle: no cached values, getters read through the driver
+#ifndef SENSOR_COMPACT
+#define SENSOR_COMPACT          0
+#endif
+
+// Static dispatch for firmware with one driver type known at build time:
+// define SENSOR_STATIC_OPS to the adapter's ops initializer and
+// SENSOR_STATIC_HEADER to the header providing it, e.g.
+//   -DSENSOR_STATIC_HEADER='"temp_humi_adapter.h"' -DSENSOR_STATIC_OPS=AHT21_ADAPTER_OPS
+// The layer then calls the adapter through a compile-time constant ops set
+// instead of handle->ops, so adapter functions are called directly and can
+// be inlined (handle->ops is ignored, all sensors must use that driver)
+
+// Dew point, absolute humidity and heat index computed once per sample
+#ifndef SENSOR_USE_DERIVED
+#define SENSOR_USE_DERIVED      0
+#endif
+
+#if SENSOR_USE_DERIVED
+#include "sensor_derived.h"
+#endif
+
+// Sliding window statistics fed with every sample
+#ifndef SENSOR_USE_STATS
+#define SENSOR_USE_STATS        0
+#endif
+
+#if SENSOR_USE_STATS
+#include "sensor_stats.h"
+#endif
+
+// Fixed-point filter chain applied to every sample before it is cached,
+// all consumers (getters, stats, reporting, queue) see filtered values
+#ifndef SENSOR_USE_FILTER
+#define SENSOR_USE_FILTER       0
+#endif
+
+#if SENSOR_USE_FILTER
+#include "sensor_filter.h"
+#if SENSOR_COMPACT
+#error "SENSOR_USE_FILTER needs the value cache, set SENSOR_COMPACT to 0"
+#endif
+#endif
+
+// Change-based reporting: samples are published (queue, publish callback)
+// only when they leave the deadband around the last published sample or
+// the heartbeat expires
+#ifndef SENSOR_USE_REPORT
+#define SENSOR_USE_REPORT       0
+#endif
+
+// Trigger/completion time of the cached sample (sensor_get_timestamps(),
+// sensor_read_fresh() sample age), 0 disables (no effect compact, which
+// reports the driver's timestamps)
+#ifndef SENSOR_USE_TIMESTAMPS
+#define SENSOR_USE_TIMESTAMPS   0
+#endif
+
+// Channels per sensor (value cache size), drivers declare up to this many
+#ifndef SENSOR_CHANNEL_MAX
+#define SENSOR_CHANNEL_MAX      2
+#endif
+
+#if SENSOR_CHANNEL_MAX < 2
+#error "SENSOR_CHANNEL_MAX must hold the temperature/humidity layout (2)"
+#endif
+
+// Channel layout of a temperature/humidity sensor
+#define SENSOR_CHANNEL_TEMPERATURE  0
+#define SENSOR_CHANNEL_HUMIDITY     1
+
+// Fetch values from the driver on getter access instead of on every sample,
+// for high-rate sampling with sparse consumption (no effect compact); getters
+// copy from the driver inside the seqlock read section, the cache is only
+// written by sensor_ticks() (filtered samples, filters need every sample)
+#ifndef SENSOR_LAZY
+#define SENSOR_LAZY             0
+#endif
+
+// Scheduler: maximum started sensors, sensor_ticks() call interval (ms)
+// without sensor_set_clock(), also used as poll interval for busy drivers
+#ifndef SENSOR_MAX_NUM
+#define SENSOR_MAX_NUM          16      // max 255
+#endif
+#ifndef SENSOR_TICK_INTERVAL
+#define SENSOR_TICK_INTERVAL    5
+#endif
+
+// sensor_read_blocking() timeout (ms) per conversion of a sample
+#ifndef SENSOR_READ_TIMEOUT
+#define SENSOR_READ_TIMEOUT     200
+#endif
+
+// sensor_ticks() result when no sensor has a deadline
+#define SENSOR_WAKEUP_NONE      0xFFFFFFFFu
+
+// Automatic start phase: started sensors are staggered by PHASE_STEP (ms)
+// so sensors sharing a bus don't trigger on the same tick
+#define SENSOR_PHASE_AUTO       0xFFFFu
+#ifndef SENSOR_PHASE_STEP
+#define SENSOR_PHASE_STEP       10
+#endif
+
+// Sample queue per sensor - filled with every sample read (by sensor_ticks()
+// for started sensors), drained by one consumer task without locks;
+// 0 disables (max 255)
+#ifndef SENSOR_QUEUE_SIZE
+#define SENSOR_QUEUE_SIZE       0
+#endif
+
+// Orders shared data accesses against queue index and cache sequence
+// updates (compiler barrier), override with a memory barrier (__DMB())
+// when tick context and consumers run on different cores
+#ifndef SENSOR_BARRIER
+#if defined(__GNUC__)
+#define SENSOR_BARRIER()        __asm volatile ("" ::: "memory")
+#else
+#define SENSOR_BARRIER()
+#endif
+#endif
+
 // Sensor type
 typedef enum {
     SENSOR_TYPE_UNKNOWN = 0,
     SENSOR_TYPE_AHT21,
     SENSOR_TYPE_SHT30,
     SENSOR_TYPE_DHT11,
-    SENSOR_TYPE_DHT22
+    SENSOR_TYPE_DHT22,
+    SENSOR_TYPE_GENERIC             // described by its channel descriptors only
 } SensorType;
 
+// Measured quantity of a channel
+typedef enum {
+    SENSOR_CHANNEL_TYPE_TEMPERATURE = 0,
+    SENSOR_CHANNEL_TYPE_HUMIDITY,
+    SENSOR_CHANNEL_TYPE_PRESSURE,
+    SENSOR_CHANNEL_TYPE_CO2,
+    SENSOR_CHANNEL_TYPE_LIGHT,
+    SENSOR_CHANNEL_TYPE_OTHER
+} SensorChannelType;
+
+// Channel descriptor
+typedef struct {
+    SensorChannelType type;
+    const char* unit;               // e.g. "°C", "hPa", "ppm"
+    uint16_t scale;                 // fixed-point steps per unit (100 = 0.01), used by filters
+} SensorChannel;
+
 // Sensor state
 typedef enum {
     SENSOR_STATE_IDLE = 0,
     SENSOR_STATE_MEASURING,
     SENSOR_STATE_READY,
-    SENSOR_STATE_ERROR
+    SENSOR_STATE_ERROR,
+    SENSOR_STATE_INIT               // driver power-up/reset in progress
 } SensorState;
 
 // Sensor operation result
@@ -41,6 +181,12 @@ typedef enum {
 // Forward declaration
 typedef struct _TempHumiSensor TempHumiSensor;
 
+// Timestamped sample
+typedef struct {
+    uint32_t timestamp;             // sample completed (ms, scheduler clock)
+    float values[SENSOR_CHANNEL_MAX];   // one per channel, unused channels 0
+} SensorSample;
+
 // Sensor operation function pointer types (similar to MultiButton's hal_button_level)
 typedef SensorResult (*SensorInit)(void* driver_handle);
 typedef SensorResult (*SensorReset)(void* driver_handle);
@@ -48,7 +194,29 @@ typedef SensorResult (*SensorTrigger)(void* driver_handle);
 typedef SensorResult (*SensorRead)(void* driver_handle);
 typedef SensorResult (*SensorGetTemp)(void* driver_handle, float* temp);
 typedef SensorResult (*SensorGetHumi)(void* driver_handle, float* humi);
+typedef SensorResult (*SensorGetTime)(void* driver_handle, uint32_t* trigger, uint32_t* complete);
 typedef SensorState  (*SensorGetState)(void* driver_handle);
+typedef uint32_t     (*SensorPoll)(void* driver_handle, uint32_t elapsed_ms);
+typedef uint32_t     (*SensorReadWait)(void* driver_handle);
+typedef uint8_t      (*SensorConversions)(void* driver_handle);
+typedef SensorResult (*SensorGetValues)(void* driver_handle, float* values, uint8_t count);
+
+// Monotonic millisecond clock (e.g. HAL_GetTick)
+typedef uint32_t (*SensorClock)(void);
+
+// Publish callback for change-based reporting
+typedef void (*SensorPublish)(TempHumiSensor* handle, const SensorSample* sample);
+
+// Wait strategy for blocking reads (similar to IIC_HAL_Ops)
+typedef void    (*SensorDelay)(uint32_t ms);
+typedef uint8_t (*SensorWaitEvent)(TempHumiSensor* handle, uint32_t timeout_ms);
+typedef void    (*SensorSignal)(TempHumiSensor* handle);
+
+typedef struct {
+    SensorDelay     delay;          // sleep ms - HAL_Delay, osDelay, vTaskDelay
+    SensorWaitEvent wait;           // block until signalled, 1 = signalled (optional)
+    SensorSignal    signal;         // wake waiter, called by sensor_ticks() once per wait (optional)
+} SensorWaitOps;
 
 // Sensor operation interface (similar to IIC_HAL_Ops design)
 typedef struct {
@@ -56,24 +224,85 @@ typedef struct {
     SensorReset     reset;          // reset
     SensorTrigger   trigger;        // trigger measurement
     SensorRead      read;           // read data
-    SensorGetTemp   get_temp;       // get temperature
-    SensorGetHumi   get_humi;       // get humidity
+    SensorGetTemp   get_temp;       // get temperature (temp/humi drivers)
+    SensorGetHumi   get_humi;       // get humidity (temp/humi drivers)
+    SensorGetValues get_values;     // get all channels, replaces get_temp/get_humi (optional)
+    SensorGetTime   get_time;       // get trigger/completion time, compact handle only (optional)
     SensorGetState  get_state;      // get state
+    SensorPoll      poll;           // advance driver power-up/reset/recovery by elapsed ms,
+                                    // returns ms until it needs the next poll (optional)
+    SensorReadWait  read_wait;      // ms until the next read after read returned BUSY, e.g. a
+                                    // conversion restarted for oversampling, 0 = next tick (optional)
+    SensorConversions get_conversions;  // conversions per sample, scales the
+                                    // sensor_read_blocking() timeout (optional, 1)
+    uint16_t        measure_time;   // conversion time (ms), 0 polls every tick
+    const SensorChannel* channels;  // channel descriptors, NULL = temperature/humidity
+    uint8_t         channel_count;  // entries in channels (max SENSOR_CHANNEL_MAX)
 } SensorOps;
 
 // Unified sensor handle
 struct _TempHumiSensor {
-    SensorType type;                // sensor type
     const SensorOps* ops;           // operation function set
     void* driver_handle;            // specific driver handle (AHT21_Handle* or SHT30_Handle*)
     
-    // Cached data
-    float temperature;
-    float humidity;
-    SensorState state;
+#if !SENSOR_COMPACT
+    // Cached data - seqlock, readers retry while seq is odd or changed
+    volatile uint16_t seq;          // incremented before and after each update
+    uint8_t sampled;                // cache holds a sample, kept while the next is measured
+#if SENSOR_LAZY
+    uint8_t cached;                 // values hold the sample, otherwise getters read the driver
+#endif
+    float values[SENSOR_CHANNEL_MAX];   // one per channel
+#if SENSOR_USE_TIMESTAMPS
+    uint32_t trigger_time;          // measurement triggered (ms, scheduler clock)
+    uint32_t sample_time;           // measurement completed (ms, scheduler clock)
+    uint32_t triggered;             // trigger of the conversion in flight (ms)
+#endif
+#if SENSOR_USE_DERIVED && !SENSOR_LAZY
+    SensorDerived derived;          // derived values of cached sample
+#endif
+#endif
+    
+    // Pacing
+    uint32_t interval;              // measurement interval (ms), 0 = measure once
+    uint32_t next_cycle;            // next periodic trigger (ms), start phase until started
+    
+    // Scheduler - started sensors are kept in a min-heap on deadline
+    uint32_t deadline;              // next handler run (ms)
+    uint16_t delay;                 // deadline - time it was set (ms, saturated)
+    uint8_t parked;                 // nothing to do until triggered/reset
+    uint8_t slot;                   // heap position + 1, 0 = not started
+    volatile uint8_t kick;          // triggered/reset by a task, rescheduled by sensor_ticks()
+    volatile uint8_t waiting;       // blocking read waits for the completion signal
+    volatile uint8_t wait_result;   // read result handed to the waiter (SensorResult)
+    uint8_t type;                   // sensor type (SensorType), packed with the bytes above
+    
+#if SENSOR_USE_FILTER
+    SensorFilter* filters;          // attached filter stages, run in attach order
+#endif
     
-    // Linked list support (similar to MultiButton's next)
-    TempHumiSensor* next;
+#if SENSOR_USE_STATS
+    SensorStats* stats;             // attached statistics windows
+#endif
+    
+#if SENSOR_USE_REPORT
+    // Change-based reporting
+    float deadband[SENSOR_CHANNEL_MAX]; // publish on change of at least (channel unit), 0 = always
+    uint32_t heartbeat;             // publish at least every (ms), 0 = off
+    SensorPublish publish;          // called for every published sample
+    SensorSample published;         // last published sample
+    uint8_t has_published;          // published holds a sample
+    uint8_t publish_last;           // last sample read was published
+    uint32_t suppressed;            // samples inside deadband, not published
+#endif
+    
+#if SENSOR_QUEUE_SIZE > 0
+    // Sample queue - head written by the reader of samples only, tail by consumer only
+    volatile uint8_t queue_head;    // next write slot (producer)
+    volatile uint8_t queue_tail;    // next read slot (consumer)
+    uint16_t queue_overrun;         // samples dropped on full queue
+    SensorSample queue[SENSOR_QUEUE_SIZE];
+#endif
 };
 
 #ifdef __cplusplus
@@ -88,24 +317,80 @@ void sensor_init(TempHumiSensor* handle,
                  const SensorOps* ops, 
                  void* driver_handle);
 
-// Sensor control
+// Sensor control - callable from tasks, started sensors are rescheduled by
+// the next sensor_ticks() (wake it when the MCU sleeps between deadlines)
 SensorResult sensor_reset(TempHumiSensor* handle);
 SensorResult sensor_trigger_measure(TempHumiSensor* handle);
 SensorResult sensor_read_data(TempHumiSensor* handle);
 
-// Get data
+// Generic channels - descriptors and all values of the last sample
+uint8_t sensor_get_channels(TempHumiSensor* handle, const SensorChannel** channels);
+SensorResult sensor_read_channels(TempHumiSensor* handle, float* values, uint8_t count);
+
+// Get data (temperature/humidity layout)
 SensorResult sensor_get_temperature(TempHumiSensor* handle, float* temp);
 SensorResult sensor_get_humidity(TempHumiSensor* handle, float* humi);
 SensorResult sensor_get_both(TempHumiSensor* handle, float* temp, float* humi);
+SensorResult sensor_get_timestamps(TempHumiSensor* handle, uint32_t* trigger, uint32_t* complete);
 SensorState sensor_get_state(TempHumiSensor* handle);
+#if SENSOR_USE_DERIVED
+SensorResult sensor_get_derived(TempHumiSensor* handle, SensorDerived* derived);
+#endif
 
 // Blocking read
 SensorResult sensor_read_blocking(TempHumiSensor* handle, float* temp, float* humi);
+SensorResult sensor_read_timeout(TempHumiSensor* handle, uint32_t timeout_ms, float* temp, float* humi);
+
+#if SENSOR_USE_REPORT
+// Change-based reporting - one deadband per channel in the channel's unit
+// (e.g. °C, %RH, hPa), heartbeat in ms
+void sensor_set_report(TempHumiSensor* handle, const float* deadbands,
+                       uint32_t heartbeat, SensorPublish publish);
+uint32_t sensor_get_suppressed(TempHumiSensor* handle);
+#endif
+
+#if SENSOR_USE_FILTER
+// Filter stages on one channel each (values in the channel's fixed-point
+// scale, e.g. 0.01 °C), stages of a channel run in attach order
+int sensor_filter_attach(TempHumiSensor* handle, SensorFilter* filter, uint8_t channel);
+void sensor_filter_detach(TempHumiSensor* handle, SensorFilter* filter);
+#endif
+
+#if SENSOR_USE_STATS
+// Statistics windows (e.g. 1 min, 10 min, 1 h) on one channel each
+int sensor_stats_attach(TempHumiSensor* handle, SensorStats* stats, uint8_t channel);
+void sensor_stats_detach(TempHumiSensor* handle, SensorStats* stats);
+SensorResult sensor_get_stats(TempHumiSensor* handle, const SensorStats* stats, SensorStatsResult* result);
+#endif
+
+#if SENSOR_QUEUE_SIZE > 0
+// Sample queue - samples read since the last drain, oldest first
+uint16_t sensor_queue_count(TempHumiSensor* handle);
+uint16_t sensor_queue_drain(TempHumiSensor* handle, SensorSample* samples, uint16_t max);
+#endif
+
+// Wait strategy shared by all blocking reads, NULL spins on the scheduler clock
+// (blocking reads fail with SENSOR_ERR_INVALID_PARAM if neither is set)
+void sensor_set_wait(const SensorWaitOps* wait);
+
+// Read sample not older than max_age_ms, sharing conversions between callers
+// (cached values, filtered like the getters; the sample age needs
+// SENSOR_USE_TIMESTAMPS, otherwise every call waits for a new sample)
+SensorResult sensor_read_fresh(TempHumiSensor* handle, uint32_t max_age_ms, float* temp, float* humi);
+
+// State machine - call in timer (similar to button_ticks), runs due
+// sensors only and returns ms until the next deadline
+uint32_t sensor_ticks(void);
+
+// Periodic measurement - set before sensor_start(), the phase applies to
+// that start only
+void sensor_set_interval(TempHumiSensor* handle, uint32_t interval, uint16_t phase);
 
-// State machine - call in timer (similar to button_ticks)
-void sensor_ticks(void);
+// Scheduler clock, NULL counts SENSOR_TICK_INTERVAL per sensor_ticks() call
+void sensor_set_clock(SensorClock clock);
 
-// Add/remove sensor (similar to button_start/stop)
+// Add/remove sensor (similar to button_start/stop) - from the sensor_ticks()
+// context or while it can't run (before the timer starts, critical section)
 int sensor_start(TempHumiSensor* handle);
 void sensor_stop(TempHumiSensor* handle);
 
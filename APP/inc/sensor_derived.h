@@ -0,0 +1,47 @@
+/*
+ * Derived Psychrometric Values
+ * Dew point, absolute humidity and heat index in fixed point,
+ * no logf/expf (table based log2/exp2) for soft-float targets
+ */
+
+#ifndef __SENSOR_DERIVED_H__
+#define __SENSOR_DERIVED_H__
+
+#include <stdint.h>
+
+// Input temperature range (0.01 °C), inputs outside are clamped; keeps the
+// Magnus denominators c + T and b - gamma away from zero
+#define SENSOR_DERIVED_TEMP_MIN     (-4000)
+#define SENSOR_DERIVED_TEMP_MAX     12500
+
+// Derived values of one sample, fixed point
+typedef struct {
+    int16_t dew_point;          // dew point (0.01 °C)
+    uint16_t abs_humidity;      // absolute humidity (0.01 g/m³)
+    int16_t heat_index;         // heat index (0.01 °C)
+} SensorDerived;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Inputs: temperature in 0.01 °C, relative humidity in 0.01 %RH (clamped
+// to SENSOR_DERIVED_TEMP_MIN..MAX and 0..100 %RH)
+//
+// Error versus the exact double formulas over -40..85 °C, 1..100 %RH:
+//   dew point          < 0.01 °C
+//   absolute humidity  < 0.02 g/m³ (< 0.06 % above 10 g/m³)
+//   heat index         < 0.05 °C, except right at the 80 °F switch between
+//                      simple and Rothfusz formula (NWS jump up to 1.3 °C)
+int16_t sensor_dew_point(int16_t temp, uint16_t humi);
+uint16_t sensor_abs_humidity(int16_t temp, uint16_t humi);
+int16_t sensor_heat_index(int16_t temp, uint16_t humi);
+
+// All derived values at once, shares the Magnus term
+void sensor_derived_calc(int16_t temp, uint16_t humi, SensorDerived* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SENSOR_DERIVED_H__
@@ -0,0 +1,62 @@
+/*
+ * Fixed-point Sample Filters
+ * First-order IIR, moving average and median-of-N on integer samples
+ * (e.g. 0.01 °C), chained per sensor channel, storage supplied by caller
+ */
+
+#ifndef __SENSOR_FILTER_H__
+#define __SENSOR_FILTER_H__
+
+#include <stdint.h>
+
+// Largest median window (sorted on the stack)
+#ifndef SENSOR_FILTER_MEDIAN_MAX
+#define SENSOR_FILTER_MEDIAN_MAX    15
+#endif
+
+// IIR state fraction bits, at least the largest shift (15) so the
+// truncated step can't stall short of the input
+#define SENSOR_FILTER_IIR_FRAC      16
+
+// Filter type
+typedef enum {
+    SENSOR_FILTER_IIR = 0,      // y += (x - y) / 2^shift
+    SENSOR_FILTER_AVERAGE,      // mean of last length samples
+    SENSOR_FILTER_MEDIAN        // median of last length samples
+} SensorFilterType;
+
+typedef struct _SensorFilter SensorFilter;
+
+// Filter stage
+struct _SensorFilter {
+    SensorFilterType type;
+    uint8_t shift;              // IIR smoothing, alpha = 1 / 2^shift
+    uint8_t length;             // window length (average/median)
+    uint8_t count;              // samples in window
+    uint8_t head;               // next window slot
+    int64_t acc;                // IIR output (Q16) or window sum, no overflow for any int32 input
+    int32_t* window;            // length entries (average/median)
+
+    // Sensor layer chaining (sensor_filter_attach)
+    uint8_t channel;            // SENSOR_CHANNEL_* filtered by this stage
+    SensorFilter* next;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Stage setup
+void sensor_filter_iir(SensorFilter* filter, uint8_t shift);
+void sensor_filter_average(SensorFilter* filter, int32_t* window, uint8_t length);
+void sensor_filter_median(SensorFilter* filter, int32_t* window, uint8_t length);
+void sensor_filter_reset(SensorFilter* filter);
+
+// Feed one sample, returns filtered value
+int32_t sensor_filter_run(SensorFilter* filter, int32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SENSOR_FILTER_H__
@@ -0,0 +1,57 @@
+/*
+ * Sliding Window Statistics
+ * Min/max/mean/variance over the last N samples, O(1) amortized per sample:
+ * windowed Welford moments (recomputed from the window once per N samples
+ * so rounding can't accumulate) plus monotonic deques for min/max
+ */
+
+#ifndef __SENSOR_STATS_H__
+#define __SENSOR_STATS_H__
+
+#include <stdint.h>
+
+typedef struct _SensorStats SensorStats;
+
+// Window statistics snapshot
+typedef struct {
+    float min;
+    float max;
+    float mean;
+    float variance;             // population variance
+    uint16_t count;             // samples in window
+} SensorStatsResult;
+
+// Sliding window over capacity samples, storage supplied by caller
+// (e.g. 1 h at 10 s interval: capacity 360)
+struct _SensorStats {
+    float* values;              // last samples, ring of capacity entries
+    uint16_t* min_deque;        // ring indices, values ascending
+    uint16_t* max_deque;        // ring indices, values descending
+    uint16_t capacity;
+    uint16_t count;             // samples in window
+    uint16_t head;              // next ring slot (oldest sample when full)
+    uint16_t min_first, min_count;
+    uint16_t max_first, max_count;
+    float mean;
+    float m2;                   // sum of squared deviations
+
+    // Sensor layer chaining (sensor_stats_attach)
+    uint8_t channel;            // SENSOR_CHANNEL_* fed into this window
+    SensorStats* next;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// deque needs 2 * capacity entries
+void sensor_stats_init(SensorStats* stats, float* values, uint16_t* deque, uint16_t capacity);
+void sensor_stats_reset(SensorStats* stats);
+void sensor_stats_add(SensorStats* stats, float value);
+void sensor_stats_get(const SensorStats* stats, SensorStatsResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SENSOR_STATS_H__
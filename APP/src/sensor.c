@@ -4,11 +4,79 @@
 
 #include "sensor_temp_humi.h"
 
-// Sensor linked list head (similar to MultiButton's head_handle)
-static TempHumiSensor* head_sensor = NULL;
+#ifdef SENSOR_STATIC_OPS
+#include SENSOR_STATIC_HEADER
+// Ops known at build time - members fold to constants, calls go direct
+static const SensorOps sensor_static_ops = SENSOR_STATIC_OPS;
+#define SENSOR_OPS(handle)      (&sensor_static_ops)
+#else
+#define SENSOR_OPS(handle)      ((handle)->ops)
+#endif
+
+// Started sensors, min-heap ordered by deadline (parked sensors last)
+static TempHumiSensor* sensor_heap[SENSOR_MAX_NUM];
+static uint8_t sensor_count = 0;
+static volatile uint8_t sensor_kicked = 0;      // some handle has kick set
+
+// Scheduler time base
+static SensorClock sensor_clock = NULL;
+static uint32_t sensor_uptime = 0;
+
+// Blocking read wait strategy
+static const SensorWaitOps* sensor_wait = NULL;
+
+// Channels of drivers without descriptors
+static const SensorChannel sensor_temp_humi_channels[2] = {
+    { SENSOR_CHANNEL_TYPE_TEMPERATURE, "°C", 100 },
+    { SENSOR_CHANNEL_TYPE_HUMIDITY, "%RH", 100 }
+};
 
 // Internal state machine handler
 static void sensor_handler(TempHumiSensor* handle);
+static uint32_t sensor_now(void);
+static SensorResult sensor_driver_reset(TempHumiSensor* handle);
+static SensorResult sensor_driver_trigger(TempHumiSensor* handle);
+static void sensor_kick(TempHumiSensor* handle);
+static void sensor_run_kicks(void);
+static void sensor_delay(uint32_t ms);
+static uint32_t sensor_busy_delay(TempHumiSensor* handle);
+static uint32_t sensor_blocking_timeout(TempHumiSensor* handle);
+static SensorResult sensor_read_wait(TempHumiSensor* handle, uint32_t timeout_ms, uint8_t join,
+                                     float* temp, float* humi);
+static SensorResult sensor_driver_values(TempHumiSensor* handle, float* values);
+#if SENSOR_USE_FILTER
+static void sensor_filter_apply(TempHumiSensor* handle);
+#endif
+#if SENSOR_USE_STATS || SENSOR_USE_REPORT || SENSOR_QUEUE_SIZE > 0
+static SensorResult sensor_sample_values(TempHumiSensor* handle, float* values);
+#endif
+#if SENSOR_USE_STATS
+static void sensor_stats_feed(TempHumiSensor* handle);
+#endif
+#if SENSOR_USE_REPORT
+static void sensor_report(TempHumiSensor* handle);
+#endif
+#if SENSOR_QUEUE_SIZE > 0
+static void sensor_queue_push(TempHumiSensor* handle);
+#endif
+static void sensor_schedule(TempHumiSensor* handle, uint32_t delay);
+static void sensor_schedule_at(TempHumiSensor* handle, uint32_t deadline);
+static void sensor_start_cycle(TempHumiSensor* handle);
+static void sensor_park(TempHumiSensor* handle);
+static uint8_t sensor_heap_less(const TempHumiSensor* a, const TempHumiSensor* b);
+static void sensor_heap_swap(uint8_t i, uint8_t j);
+static void sensor_heap_fix(uint8_t pos);
+#if SENSOR_USE_DERIVED
+static uint8_t sensor_is_temp_humi(TempHumiSensor* handle);
+static void sensor_calc_derived(float temp, float humi, SensorDerived* derived);
+#endif
+#if !SENSOR_COMPACT
+static SensorResult sensor_fetch(TempHumiSensor* handle, float* values);
+static void sensor_write_begin(TempHumiSensor* handle);
+static void sensor_write_end(TempHumiSensor* handle);
+static uint16_t sensor_read_begin(TempHumiSensor* handle);
+static uint8_t sensor_read_retry(TempHumiSensor* handle, uint16_t seq);
+#endif
 
 /**
   * @brief  Initialize sensor handle
@@ -24,38 +92,40 @@ void sensor_init(TempHumiSensor* handle,
     handle->type = type;
     handle->ops = ops;
     handle->driver_handle = driver_handle;
-    handle->state = SENSOR_STATE_IDLE;
+    handle->next_cycle = SENSOR_PHASE_AUTO;
     
     // Call specific driver initialization
-    if (handle->ops->init) {
-        handle->ops->init(driver_handle);
+    if (SENSOR_OPS(handle)->init) {
+        SENSOR_OPS(handle)->init(driver_handle);
     }
 }
 
 /**
   * @brief  Reset sensor
+  * @note   Doesn't touch the scheduler, sensor_ticks() picks the sensor up
   */
 SensorResult sensor_reset(TempHumiSensor* handle)
 {
-    if (!handle || !handle->ops->reset) return SENSOR_ERR_INVALID_PARAM;
+    if (!handle) return SENSOR_ERR_INVALID_PARAM;
     
-    SensorResult result = handle->ops->reset(handle->driver_handle);
+    SensorResult result = sensor_driver_reset(handle);
     if (result == SENSOR_OK) {
-        handle->state = SENSOR_STATE_IDLE;
+        sensor_kick(handle);
     }
     return result;
 }
 
 /**
   * @brief  Trigger measurement
+  * @note   Doesn't touch the scheduler, sensor_ticks() reads the sample
   */
 SensorResult sensor_trigger_measure(TempHumiSensor* handle)
 {
-    if (!handle || !handle->ops->trigger) return SENSOR_ERR_INVALID_PARAM;
+    if (!handle) return SENSOR_ERR_INVALID_PARAM;
     
-    SensorResult result = handle->ops->trigger(handle->driver_handle);
+    SensorResult result = sensor_driver_trigger(handle);
     if (result == SENSOR_OK) {
-        handle->state = SENSOR_STATE_MEASURING;
+        sensor_kick(handle);
     }
     return result;
 }
@@ -65,28 +135,132 @@ SensorResult sensor_trigger_measure(TempHumiSensor* handle)
   */
 SensorResult sensor_read_data(TempHumiSensor* handle)
 {
-    if (!handle || !handle->ops->read) return SENSOR_ERR_INVALID_PARAM;
+    if (!handle || !SENSOR_OPS(handle)->read) return SENSOR_ERR_INVALID_PARAM;
     
-    SensorResult result = handle->ops->read(handle->driver_handle);
+#if !SENSOR_COMPACT && SENSOR_LAZY
+    // Lazy getters copy from the driver, which the read updates
+    sensor_write_begin(handle);
+#endif
+    SensorResult result = SENSOR_OPS(handle)->read(handle->driver_handle);
     if (result == SENSOR_OK) {
+#if !SENSOR_COMPACT
         // Update cached data
-        handle->ops->get_temp(handle->driver_handle, &handle->temperature);
-        handle->ops->get_humi(handle->driver_handle, &handle->humidity);
-        handle->state = SENSOR_STATE_READY;
+#if SENSOR_LAZY
+        handle->cached = 0;
+#if SENSOR_USE_FILTER
+        // Filters need every sample, no deferred fetch
+        if (handle->filters && sensor_driver_values(handle, handle->values) == SENSOR_OK) {
+            sensor_filter_apply(handle);
+            handle->cached = 1;
+        }
+#endif
+#else
+        sensor_write_begin(handle);
+        sensor_driver_values(handle, handle->values);
+#if SENSOR_USE_FILTER
+        sensor_filter_apply(handle);
+#endif
+#if SENSOR_USE_DERIVED
+        if (sensor_is_temp_humi(handle)) {
+            sensor_calc_derived(handle->values[SENSOR_CHANNEL_TEMPERATURE],
+                                handle->values[SENSOR_CHANNEL_HUMIDITY], &handle->derived);
+        }
+#endif
+#endif
+#if SENSOR_USE_TIMESTAMPS
+        handle->trigger_time = handle->triggered;
+        handle->sample_time = sensor_now();
+#endif
+        handle->sampled = 1;
+#endif
+#if SENSOR_USE_STATS
+        sensor_stats_feed(handle);
+#endif
+    }
+#if !SENSOR_COMPACT
+    if (result == SENSOR_OK || SENSOR_LAZY) {
+        sensor_write_end(handle);
+    }
+#endif
+    if (result == SENSOR_OK) {
+#if SENSOR_USE_REPORT
+        sensor_report(handle);
+#endif
+#if SENSOR_QUEUE_SIZE > 0 && SENSOR_USE_REPORT
+        if (handle->publish_last) sensor_queue_push(handle);
+#elif SENSOR_QUEUE_SIZE > 0
+        sensor_queue_push(handle);
+#endif
     }
     return result;
 }
 
+/**
+  * @brief  Get channel descriptors
+  * @retval Number of channels
+  */
+uint8_t sensor_get_channels(TempHumiSensor* handle, const SensorChannel** channels)
+{
+    if (!handle) return 0;
+    
+    const SensorChannel* desc = sensor_temp_humi_channels;
+    uint8_t count = 2;
+    if (SENSOR_OPS(handle)->channels) {
+        desc = SENSOR_OPS(handle)->channels;
+        count = SENSOR_OPS(handle)->channel_count;
+        if (count > SENSOR_CHANNEL_MAX) count = SENSOR_CHANNEL_MAX;
+    }
+    
+    if (channels) *channels = desc;
+    return count;
+}
+
+/**
+  * @brief  Read first count channel values of the last sample
+  */
+SensorResult sensor_read_channels(TempHumiSensor* handle, float* values, uint8_t count)
+{
+    if (!handle || !values || count > sensor_get_channels(handle, NULL)) return SENSOR_ERR_INVALID_PARAM;
+    
+    uint8_t ch;
+#if SENSOR_COMPACT
+    // Driver keeps its last sample while the next one is measured
+    float all[SENSOR_CHANNEL_MAX];
+    SensorResult result = sensor_driver_values(handle, all);
+    if (result != SENSOR_OK) return result;
+    for (ch = 0; ch < count; ch++) {
+        values[ch] = all[ch];
+    }
+#else
+    if (!handle->sampled) return SENSOR_ERR_NOT_READY;
+    
+    // Consistent set even if sensor_ticks() updates in between
+    float all[SENSOR_CHANNEL_MAX];
+    SensorResult result;
+    uint16_t seq;
+    do {
+        seq = sensor_read_begin(handle);
+        result = sensor_fetch(handle, all);
+    } while (sensor_read_retry(handle, seq));
+    if (result != SENSOR_OK) return result;
+    for (ch = 0; ch < count; ch++) {
+        values[ch] = all[ch];
+    }
+#endif
+    return SENSOR_OK;
+}
+
 /**
   * @brief  Get temperature
   */
 SensorResult sensor_get_temperature(TempHumiSensor* handle, float* temp)
 {
-    if (!handle || !temp) return SENSOR_ERR_INVALID_PARAM;
-    if (handle->state != SENSOR_STATE_READY) return SENSOR_ERR_NOT_READY;
+    if (!temp) return SENSOR_ERR_INVALID_PARAM;
     
-    *temp = handle->temperature;
-    return SENSOR_OK;
+    float values[SENSOR_CHANNEL_MAX];
+    SensorResult result = sensor_read_channels(handle, values, SENSOR_CHANNEL_TEMPERATURE + 1);
+    if (result == SENSOR_OK) *temp = values[SENSOR_CHANNEL_TEMPERATURE];
+    return result;
 }
 
 /**
@@ -94,11 +268,12 @@ SensorResult sensor_get_temperature(TempHumiSensor* handle, float* temp)
   */
 SensorResult sensor_get_humidity(TempHumiSensor* handle, float* humi)
 {
-    if (!handle || !humi) return SENSOR_ERR_INVALID_PARAM;
-    if (handle->state != SENSOR_STATE_READY) return SENSOR_ERR_NOT_READY;
+    if (!humi) return SENSOR_ERR_INVALID_PARAM;
     
-    *humi = handle->humidity;
-    return SENSOR_OK;
+    float values[SENSOR_CHANNEL_MAX];
+    SensorResult result = sensor_read_channels(handle, values, SENSOR_CHANNEL_HUMIDITY + 1);
+    if (result == SENSOR_OK) *humi = values[SENSOR_CHANNEL_HUMIDITY];
+    return result;
 }
 
 /**
@@ -106,131 +281,984 @@ SensorResult sensor_get_humidity(TempHumiSensor* handle, float* humi)
   */
 SensorResult sensor_get_both(TempHumiSensor* handle, float* temp, float* humi)
 {
-    if (!handle || !temp || !humi) return SENSOR_ERR_INVALID_PARAM;
-    if (handle->state != SENSOR_STATE_READY) return SENSOR_ERR_NOT_READY;
+    if (!temp || !humi) return SENSOR_ERR_INVALID_PARAM;
+    
+    float values[SENSOR_CHANNEL_MAX];
+    SensorResult result = sensor_read_channels(handle, values, 2);
+    if (result == SENSOR_OK) {
+        *temp = values[SENSOR_CHANNEL_TEMPERATURE];
+        *humi = values[SENSOR_CHANNEL_HUMIDITY];
+    }
+    return result;
+}
+
+/**
+  * @brief  Get trigger and completion time of last sample (ms)
+  * @note   Scheduler clock, compact handles report the driver's clock
+  *         (SENSOR_ERR_NOT_READY if the driver has none, or without
+  *         SENSOR_USE_TIMESTAMPS)
+  */
+SensorResult sensor_get_timestamps(TempHumiSensor* handle, uint32_t* trigger, uint32_t* complete)
+{
+    if (!handle || !trigger || !complete) return SENSOR_ERR_INVALID_PARAM;
+    
+#if SENSOR_COMPACT
+    if (!SENSOR_OPS(handle)->get_time) return SENSOR_ERR_NOT_READY;
+    return SENSOR_OPS(handle)->get_time(handle->driver_handle, trigger, complete);
+#elif SENSOR_USE_TIMESTAMPS
+    if (!handle->sampled) return SENSOR_ERR_NOT_READY;
+    uint16_t seq;
+    do {
+        seq = sensor_read_begin(handle);
+        *trigger = handle->trigger_time;
+        *complete = handle->sample_time;
+    } while (sensor_read_retry(handle, seq));
+    return SENSOR_OK;
+#else
+    return SENSOR_ERR_NOT_READY;
+#endif
+}
+
+#if SENSOR_USE_DERIVED
+/**
+  * @brief  Get dew point, absolute humidity and heat index of last sample
+  */
+SensorResult sensor_get_derived(TempHumiSensor* handle, SensorDerived* derived)
+{
+    if (!handle || !derived || !sensor_is_temp_humi(handle)) return SENSOR_ERR_INVALID_PARAM;
     
-    *temp = handle->temperature;
-    *humi = handle->humidity;
+#if SENSOR_COMPACT
+    float temp, humi;
+    SensorResult result = sensor_get_both(handle, &temp, &humi);
+    if (result != SENSOR_OK) return result;
+    sensor_calc_derived(temp, humi, derived);
+#elif SENSOR_LAZY
+    // Computed from the values on every access, nothing is written back
+    float values[SENSOR_CHANNEL_MAX];
+    SensorResult result = sensor_read_channels(handle, values, 2);
+    if (result != SENSOR_OK) return result;
+    sensor_calc_derived(values[SENSOR_CHANNEL_TEMPERATURE], values[SENSOR_CHANNEL_HUMIDITY], derived);
+#else
+    if (!handle->sampled) return SENSOR_ERR_NOT_READY;
+    uint16_t seq;
+    do {
+        seq = sensor_read_begin(handle);
+        *derived = handle->derived;
+    } while (sensor_read_retry(handle, seq));
+#endif
     return SENSOR_OK;
 }
+#endif
 
 /**
   * @brief  Get sensor state
   */
 SensorState sensor_get_state(TempHumiSensor* handle)
 {
-    if (!handle || !handle->ops->get_state) return SENSOR_STATE_ERROR;
-    return handle->ops->get_state(handle->driver_handle);
+    if (!handle || !SENSOR_OPS(handle)->get_state) return SENSOR_STATE_ERROR;
+    return SENSOR_OPS(handle)->get_state(handle->driver_handle);
 }
 
 /**
-  * @brief  Blocking read
+  * @brief  Blocking read, SENSOR_READ_TIMEOUT per conversion of a sample
   */
 SensorResult sensor_read_blocking(TempHumiSensor* handle, float* temp, float* humi)
+{
+    if (!handle) return SENSOR_ERR_INVALID_PARAM;
+    
+    return sensor_read_timeout(handle, sensor_blocking_timeout(handle), temp, humi);
+}
+
+/**
+  * @brief  Blocking read with timeout (ms)
+  * @note   Started sensors are read by sensor_ticks(), which signals the
+  *         waiter with event wait ops. Otherwise the conversion time is slept
+  *         through with the delay op, then the state is polled every
+  *         SENSOR_TICK_INTERVAL (sensors not started are read here).
+  * @retval SENSOR_ERR_INVALID_PARAM without wait ops and scheduler clock
+  */
+SensorResult sensor_read_timeout(TempHumiSensor* handle, uint32_t timeout_ms, float* temp, float* humi)
 {
     if (!handle || !temp || !humi) return SENSOR_ERR_INVALID_PARAM;
     
-    SensorResult result;
+    return sensor_read_wait(handle, timeout_ms, 0, temp, humi);
+}
+
+/**
+  * @brief  Trigger (or join the conversion in flight) and wait for the sample
+  * @param  join: wait for a conversion already in flight instead of failing
+  *         with SENSOR_ERR_BUSY
+  */
+static SensorResult sensor_read_wait(TempHumiSensor* handle, uint32_t timeout_ms, uint8_t join,
+                                     float* temp, float* humi)
+{
+    SensorResult result = SENSOR_OK;
+    
+    if (handle->slot && sensor_wait && sensor_wait->wait && sensor_wait->signal) {
+        // Completion event from the scheduler, registered before triggering
+        // so only this read is signalled. The handler hands over its read
+        // result, the state may already be the next cycle's
+        handle->waiting = 1;
+        if (!join || sensor_get_state(handle) != SENSOR_STATE_MEASURING) {
+            result = sensor_trigger_measure(handle);
+        }
+        if (result == SENSOR_OK && !sensor_wait->wait(handle, timeout_ms)) result = SENSOR_ERR_TIMEOUT;
+        handle->waiting = 0;
+        if (result != SENSOR_OK) return result;
+        
+        result = (SensorResult)handle->wait_result;
+        if (result != SENSOR_OK) return result;
+        return sensor_get_both(handle, temp, humi);
+    }
+    
+    // Polling needs a delay op or a clock to spin on, otherwise the
+    // timeout would pass without waiting at all
+    if (!(sensor_wait && sensor_wait->delay) && !sensor_clock) return SENSOR_ERR_INVALID_PARAM;
     
     // Trigger measurement
-    result = sensor_trigger_measure(handle);
-    if (result != SENSOR_OK) return result;
+    if (!join || sensor_get_state(handle) != SENSOR_STATE_MEASURING) {
+        result = sensor_trigger_measure(handle);
+        if (result != SENSOR_OK) return result;
+    }
+    
+    // Sleep through conversion, then poll
+    uint32_t waited = SENSOR_OPS(handle)->measure_time;
+    if (waited > timeout_ms) waited = timeout_ms;
+    sensor_delay(waited);
     
-    // Wait for measurement to complete (poll status)
-    uint16_t timeout = 1000;  // 100ms timeout
-    while (timeout--) {
+    for (;;) {
         SensorState state = sensor_get_state(handle);
-        if (state == SENSOR_STATE_READY || state != SENSOR_STATE_MEASURING) {
-            break;
+        if (state == SENSOR_STATE_READY) break;         // read by sensor_ticks()
+        if (state != SENSOR_STATE_MEASURING) return SENSOR_ERR_COMM;
+        
+        // Started sensors are read by sensor_ticks() only, it feeds the queue
+        if (!handle->slot) {
+            result = sensor_read_data(handle);
+            if (result == SENSOR_OK) break;
+            if (result != SENSOR_ERR_BUSY) return result;
         }
-        // Delay 100us (needs hardware layer support)
+        
+        if (waited >= timeout_ms) return SENSOR_ERR_TIMEOUT;
+        uint32_t delay = handle->slot ? SENSOR_TICK_INTERVAL : sensor_busy_delay(handle);
+        sensor_delay(delay);
+        waited += delay;
     }
     
-    // Read data
-    result = sensor_read_data(handle);
-    if (result != SENSOR_OK) return result;
-    
     return sensor_get_both(handle, temp, humi);
 }
 
+#if SENSOR_USE_REPORT
+/**
+  * @brief  Configure change-based reporting
+  * @param  deadbands: change needed to publish, one per channel (see
+  *         sensor_get_channels), 0 or NULL publishes every sample
+  * @param  heartbeat: publish at least every heartbeat ms, 0 = off
+  * @param  publish: callback for published samples (optional)
+  */
+void sensor_set_report(TempHumiSensor* handle, const float* deadbands,
+                       uint32_t heartbeat, SensorPublish publish)
+{
+    if (!handle) return;
+    
+    uint8_t count = sensor_get_channels(handle, NULL);
+    uint8_t ch;
+    for (ch = 0; ch < SENSOR_CHANNEL_MAX; ch++) {
+        handle->deadband[ch] = (deadbands && ch < count) ? deadbands[ch] : 0;
+    }
+    handle->heartbeat = heartbeat;
+    handle->publish = publish;
+    handle->has_published = 0;
+    handle->suppressed = 0;
+}
+
 /**
-  * @brief  Add sensor to working list (similar to button_start)
+  * @brief  Number of samples suppressed by the deadbands
+  */
+uint32_t sensor_get_suppressed(TempHumiSensor* handle)
+{
+    return handle ? handle->suppressed : 0;
+}
+#endif
+
+#if SENSOR_USE_FILTER
+/**
+  * @brief  Attach filter stage to channel, runs after the stages attached before
+  * @retval 0 ok, -1 already attached, -2 invalid
+  */
+int sensor_filter_attach(TempHumiSensor* handle, SensorFilter* filter, uint8_t channel)
+{
+    if (!handle || !filter || channel >= sensor_get_channels(handle, NULL)) return -2;
+    
+    SensorFilter** tail;
+    for (tail = &handle->filters; *tail; tail = &(*tail)->next) {
+        if (*tail == filter) return -1;
+    }
+    
+    sensor_filter_reset(filter);
+    filter->channel = channel;
+    filter->next = NULL;
+    *tail = filter;
+    return 0;
+}
+
+/**
+  * @brief  Detach filter stage
+  */
+void sensor_filter_detach(TempHumiSensor* handle, SensorFilter* filter)
+{
+    if (!handle || !filter) return;
+    
+    SensorFilter** curr;
+    for (curr = &handle->filters; *curr; curr = &(*curr)->next) {
+        if (*curr == filter) {
+            *curr = filter->next;
+            filter->next = NULL;
+            return;
+        }
+    }
+}
+#endif
+
+#if SENSOR_USE_STATS
+/**
+  * @brief  Attach statistics window fed with channel of every sample
+  * @retval 0 ok, -1 already attached, -2 invalid
+  */
+int sensor_stats_attach(TempHumiSensor* handle, SensorStats* stats, uint8_t channel)
+{
+    if (!handle || !stats || channel >= sensor_get_channels(handle, NULL)) return -2;
+    
+    SensorStats* target;
+    for (target = handle->stats; target; target = target->next) {
+        if (target == stats) return -1;
+    }
+    
+    stats->channel = channel;
+    stats->next = handle->stats;
+    handle->stats = stats;
+    return 0;
+}
+
+/**
+  * @brief  Detach statistics window
+  */
+void sensor_stats_detach(TempHumiSensor* handle, SensorStats* stats)
+{
+    if (!handle || !stats) return;
+    
+    SensorStats** curr;
+    for (curr = &handle->stats; *curr; curr = &(*curr)->next) {
+        if (*curr == stats) {
+            *curr = stats->next;
+            stats->next = NULL;
+            return;
+        }
+    }
+}
+
+/**
+  * @brief  Consistent snapshot of an attached statistics window
+  */
+SensorResult sensor_get_stats(TempHumiSensor* handle, const SensorStats* stats, SensorStatsResult* result)
+{
+    if (!handle || !stats || !result) return SENSOR_ERR_INVALID_PARAM;
+    
+#if SENSOR_COMPACT
+    sensor_stats_get(stats, result);
+#else
+    uint16_t seq;
+    do {
+        seq = sensor_read_begin(handle);
+        sensor_stats_get(stats, result);
+    } while (sensor_read_retry(handle, seq));
+#endif
+    return result->count ? SENSOR_OK : SENSOR_ERR_NOT_READY;
+}
+#endif
+
+#if SENSOR_QUEUE_SIZE > 0
+/**
+  * @brief  Number of samples waiting in queue
+  */
+uint16_t sensor_queue_count(TempHumiSensor* handle)
+{
+    if (!handle) return 0;
+    
+    uint8_t head = handle->queue_head;
+    uint8_t tail = handle->queue_tail;
+    return (head >= tail) ? (head - tail) : (SENSOR_QUEUE_SIZE - tail + head);
+}
+
+/**
+  * @brief  Drain up to max samples from queue, oldest first
+  * @note   Single consumer - call from one task only
+  */
+uint16_t sensor_queue_drain(TempHumiSensor* handle, SensorSample* samples, uint16_t max)
+{
+    if (!handle || !samples) return 0;
+    
+    uint8_t head = handle->queue_head;
+    uint8_t tail = handle->queue_tail;
+    uint16_t count = 0;
+    
+    SENSOR_BARRIER();
+    while (tail != head && count < max) {
+        samples[count++] = handle->queue[tail];
+        tail = (tail + 1 < SENSOR_QUEUE_SIZE) ? (tail + 1) : 0;
+    }
+    SENSOR_BARRIER();
+    
+    handle->queue_tail = tail;
+    return count;
+}
+#endif
+
+/**
+  * @brief  Set wait strategy for blocking reads
+  */
+void sensor_set_wait(const SensorWaitOps* wait)
+{
+    sensor_wait = wait;
+}
+
+/**
+  * @brief  Read sample not older than max_age_ms
+  * @note   Served from the last sample while young enough, otherwise waits
+  *         like sensor_read_blocking() and joins a conversion already in
+  *         flight, so started sensors are still read by sensor_ticks() only.
+  *         Compact handles age the driver's timestamps, the driver clock
+  *         must then be the scheduler clock (e.g. both HAL_GetTick)
+  */
+SensorResult sensor_read_fresh(TempHumiSensor* handle, uint32_t max_age_ms, float* temp, float* humi)
+{
+    if (!handle || !temp || !humi) return SENSOR_ERR_INVALID_PARAM;
+    
+    // Last sample still young enough
+    uint32_t trigger, complete;
+    if (sensor_get_timestamps(handle, &trigger, &complete) == SENSOR_OK &&
+        (uint32_t)(sensor_now() - complete) <= max_age_ms &&
+        sensor_get_both(handle, temp, humi) == SENSOR_OK) {
+        return SENSOR_OK;
+    }
+    
+    return sensor_read_wait(handle, sensor_blocking_timeout(handle), 1, temp, humi);
+}
+
+/**
+  * @brief  Add sensor to scheduler (similar to button_start)
+  * @retval 0 ok, -1 already started, -2 invalid, -3 SENSOR_MAX_NUM reached
   */
 int sensor_start(TempHumiSensor* handle)
 {
     if (!handle) return -2;
+    if (SENSOR_OPS(handle)->channels && SENSOR_OPS(handle)->channel_count > SENSOR_CHANNEL_MAX) return -2;
+    if (handle->slot) return -1;  // already exists
+    if (sensor_count >= SENSOR_MAX_NUM) return -3;
     
-    TempHumiSensor* target = head_sensor;
-    while (target) {
-        if (target == handle) return -1;  // already exists
-        target = target->next;
+    // Stagger first trigger behind the sensors already started
+    uint32_t phase = handle->next_cycle;
+    if (phase == SENSOR_PHASE_AUTO) {
+        phase = (uint32_t)sensor_count * SENSOR_PHASE_STEP;
+        if (handle->interval) phase %= handle->interval;
     }
     
-    handle->next = head_sensor;
-    head_sensor = handle;
+    sensor_heap[sensor_count++] = handle;
+    handle->slot = sensor_count;
+    handle->next_cycle = sensor_now() + phase;
+    sensor_schedule_at(handle, handle->next_cycle);
     return 0;
 }
 
 /**
-  * @brief  Remove sensor from working list (similar to button_stop)
+  * @brief  Remove sensor from scheduler (similar to button_stop)
   */
 void sensor_stop(TempHumiSensor* handle)
+{
+    if (!handle || !handle->slot) return;
+    
+    uint8_t pos = handle->slot - 1;
+    handle->slot = 0;
+    handle->next_cycle = SENSOR_PHASE_AUTO;     // restart staggers again
+    
+    // Move last entry into the hole
+    if (pos != --sensor_count) {
+        sensor_heap[pos] = sensor_heap[sensor_count];
+        sensor_heap[pos]->slot = pos + 1;
+        sensor_heap_fix(pos);
+    }
+}
+
+/**
+  * @brief  Set measurement interval and start phase
+  * @param  interval: ms between triggers, 0 measures once after start/reset
+  * @param  phase: first trigger ms after sensor_start(), or SENSOR_PHASE_AUTO
+  */
+void sensor_set_interval(TempHumiSensor* handle, uint32_t interval, uint16_t phase)
 {
     if (!handle) return;
     
-    TempHumiSensor** curr;
-    for (curr = &head_sensor; *curr; ) {
-        TempHumiSensor* entry = *curr;
-        if (entry == handle) {
-            *curr = entry->next;
-            entry->next = NULL;
-            return;
-        } else {
-            curr = &entry->next;
-        }
+    handle->interval = interval;
+    if (!handle->slot) {
+        handle->next_cycle = phase;     // replaced by the first cycle on start
     }
 }
 
+/**
+  * @brief  Set scheduler clock
+  * @note   Without a clock sensor_ticks() must be called every
+  *         SENSOR_TICK_INTERVAL ms, i.e. the MCU can't sleep between deadlines
+  */
+void sensor_set_clock(SensorClock clock)
+{
+    sensor_clock = clock;
+}
+
 /**
   * @brief  Sensor state machine handler (internal function)
+  * @note   Runs when the sensor deadline has passed and sets the next one
   */
 static void sensor_handler(TempHumiSensor* handle)
 {
     SensorState state = sensor_get_state(handle);
+    SensorResult result;
     
     switch (state) {
     case SENSOR_STATE_IDLE:
-        // Automatically trigger measurement
-        sensor_trigger_measure(handle);
+        // Automatically trigger measurement, read after conversion time
+        sensor_start_cycle(handle);
         break;
         
     case SENSOR_STATE_MEASURING:
-        // Wait for measurement to complete, try to read
-        sensor_read_data(handle);
+        // Conversion time passed, try to read
+        result = sensor_read_data(handle);
+        if (result != SENSOR_ERR_BUSY && handle->waiting && sensor_wait && sensor_wait->signal) {
+            handle->wait_result = (uint8_t)result;
+            handle->waiting = 0;
+            sensor_wait->signal(handle);
+        }
+        if (result == SENSOR_OK) {
+            if (handle->interval) {
+                sensor_schedule_at(handle, handle->next_cycle);
+            } else {
+                sensor_park(handle);
+            }
+        } else if (result == SENSOR_ERR_BUSY) {
+            sensor_schedule(handle, sensor_busy_delay(handle));
+        } else {
+            sensor_schedule(handle, SENSOR_TICK_INTERVAL);
+        }
         break;
         
     case SENSOR_STATE_READY:
-        // Data ready, wait for a period before remeasuring
-        // Timing logic can be added here
+        // Data ready, measure again once the interval has passed
+        if (handle->interval) {
+            sensor_start_cycle(handle);
+        } else {
+            sensor_park(handle);
+        }
         break;
         
     case SENSOR_STATE_ERROR:
-        // Error state, try to reset
-        sensor_reset(handle);
+    case SENSOR_STATE_INIT:
+        // Driver is powering up, resetting or recovering - advance it by the
+        // time since the last run and sleep until it needs the next poll
+        if (SENSOR_OPS(handle)->poll) {
+            uint32_t elapsed = sensor_now() - handle->deadline + handle->delay;
+            uint32_t wait = SENSOR_OPS(handle)->poll(handle->driver_handle, elapsed);
+            sensor_schedule(handle, wait ? wait : SENSOR_TICK_INTERVAL);
+            break;
+        }
+        if (state == SENSOR_STATE_ERROR) {
+            sensor_driver_reset(handle);
+        }
+        sensor_schedule(handle, SENSOR_TICK_INTERVAL);
         break;
         
     default:
+        sensor_schedule(handle, SENSOR_TICK_INTERVAL);
         break;
     }
 }
 
 /**
   * @brief  Background timer call (similar to button_ticks)
+  * @retval ms until the next deadline, SENSOR_WAKEUP_NONE if all are parked
   */
-void sensor_ticks(void)
+uint32_t sensor_ticks(void)
 {
-    TempHumiSensor* target;
-    for (target = head_sensor; target; target = target->next) {
-        sensor_handler(target);
+    if (!sensor_clock) {
+        sensor_uptime += SENSOR_TICK_INTERVAL;
+    }
+    uint32_t now = sensor_now();
+    
+    // Sensors triggered/reset by tasks since the last run
+    if (sensor_kicked) {
+        sensor_kicked = 0;
+        SENSOR_BARRIER();
+        sensor_run_kicks();
     }
+    
+    // Only sensors whose deadline has passed, earliest first
+    while (sensor_count && !sensor_heap[0]->parked &&
+           (int32_t)(now - sensor_heap[0]->deadline) >= 0) {
+        sensor_handler(sensor_heap[0]);
+    }
+    
+    if (!sensor_count || sensor_heap[0]->parked) return SENSOR_WAKEUP_NONE;
+    return sensor_heap[0]->deadline - now;
+}
+
+// ========== Internal Functions ==========
+
+/**
+  * @brief  Current scheduler time (ms)
+  */
+static uint32_t sensor_now(void)
+{
+    return sensor_clock ? sensor_clock() : sensor_uptime;
+}
+
+/**
+  * @brief  Reset driver
+  */
+static SensorResult sensor_driver_reset(TempHumiSensor* handle)
+{
+    if (!SENSOR_OPS(handle)->reset) return SENSOR_ERR_INVALID_PARAM;
+    
+    return SENSOR_OPS(handle)->reset(handle->driver_handle);
+}
+
+/**
+  * @brief  Trigger driver measurement
+  */
+static SensorResult sensor_driver_trigger(TempHumiSensor* handle)
+{
+    if (!SENSOR_OPS(handle)->trigger) return SENSOR_ERR_INVALID_PARAM;
+    
+    SensorResult result = SENSOR_OPS(handle)->trigger(handle->driver_handle);
+#if !SENSOR_COMPACT && SENSOR_USE_TIMESTAMPS
+    if (result == SENSOR_OK) {
+        handle->triggered = sensor_now();
+    }
+#endif
+    return result;
+}
+
+/**
+  * @brief  Ask sensor_ticks() to reschedule a started sensor (any context)
+  */
+static void sensor_kick(TempHumiSensor* handle)
+{
+    if (!handle->slot) return;
+    
+    handle->kick = 1;
+    SENSOR_BARRIER();
+    sensor_kicked = 1;
+}
+
+/**
+  * @brief  Reschedule kicked sensors - read after conversion time, else run now
+  */
+static void sensor_run_kicks(void)
+{
+    uint8_t i = 0;
+    while (i < sensor_count) {
+        TempHumiSensor* handle = sensor_heap[i];
+        if (!handle->kick) {
+            i++;
+            continue;
+        }
+        
+        handle->kick = 0;
+        if (sensor_get_state(handle) == SENSOR_STATE_MEASURING) {
+            sensor_schedule(handle, SENSOR_OPS(handle)->measure_time);
+        } else {
+            sensor_schedule(handle, 0);
+        }
+        i = 0;  // heap order changed, rescan
+    }
+}
+
+/**
+  * @brief  Trigger periodic measurement, advance cycle on the phase grid
+  */
+static void sensor_start_cycle(TempHumiSensor* handle)
+{
+    if (sensor_driver_trigger(handle) != SENSOR_OK) {
+        sensor_schedule(handle, SENSOR_TICK_INTERVAL);
+        return;
+    }
+    sensor_schedule(handle, SENSOR_OPS(handle)->measure_time);
+    
+    // Stay on the phase grid without drift, skip cycles missed while
+    // busy or in error
+    uint32_t now = sensor_now();
+    if (handle->interval) {
+        uint32_t missed = 0;
+        if ((int32_t)(now - handle->next_cycle) >= 0) {
+            missed = (now - handle->next_cycle) / handle->interval;
+        }
+        handle->next_cycle += (missed + 1) * handle->interval;
+    }
+}
+
+/**
+  * @brief  Wait ms with the wait strategy, spin on the clock without one
+  */
+static void sensor_delay(uint32_t ms)
+{
+    if (sensor_wait && sensor_wait->delay) {
+        sensor_wait->delay(ms);
+    } else if (sensor_clock) {
+        uint32_t start = sensor_clock();
+        while (sensor_clock() - start < ms) {
+        }
+    }
+}
+
+/**
+  * @brief  Time until the next read after the driver reported busy (ms)
+  * @note   A full conversion if the read started the next one of the
+  *         sample (oversampling), otherwise the next tick
+  */
+static uint32_t sensor_busy_delay(TempHumiSensor* handle)
+{
+    uint32_t wait = 0;
+    if (SENSOR_OPS(handle)->read_wait) {
+        wait = SENSOR_OPS(handle)->read_wait(handle->driver_handle);
+    }
+    return wait ? wait : SENSOR_TICK_INTERVAL;
+}
+
+/**
+  * @brief  sensor_read_blocking() timeout, SENSOR_READ_TIMEOUT per conversion
+  */
+static uint32_t sensor_blocking_timeout(TempHumiSensor* handle)
+{
+    uint32_t conversions = 1;
+    if (SENSOR_OPS(handle)->get_conversions) {
+        conversions = SENSOR_OPS(handle)->get_conversions(handle->driver_handle);
+    }
+    return SENSOR_READ_TIMEOUT * (conversions ? conversions : 1);
+}
+
+/**
+  * @brief  All channel values of the driver's last sample
+  */
+static SensorResult sensor_driver_values(TempHumiSensor* handle, float* values)
+{
+    if (SENSOR_OPS(handle)->get_values) {
+        return SENSOR_OPS(handle)->get_values(handle->driver_handle, values, sensor_get_channels(handle, NULL));
+    }
+    if (!SENSOR_OPS(handle)->get_temp || !SENSOR_OPS(handle)->get_humi) return SENSOR_ERR_INVALID_PARAM;
+    
+    SensorResult result = SENSOR_OPS(handle)->get_temp(handle->driver_handle, &values[SENSOR_CHANNEL_TEMPERATURE]);
+    if (result != SENSOR_OK) return result;
+    return SENSOR_OPS(handle)->get_humi(handle->driver_handle, &values[SENSOR_CHANNEL_HUMIDITY]);
+}
+
+#if SENSOR_USE_FILTER
+/**
+  * @brief  Run cached sample through attached filter stages (channel fixed point)
+  */
+static void sensor_filter_apply(TempHumiSensor* handle)
+{
+    if (!handle->filters) return;
+    
+    const SensorChannel* channels;
+    uint8_t count = sensor_get_channels(handle, &channels);
+    uint8_t ch;
+    for (ch = 0; ch < count; ch++) {
+        float scale = channels[ch].scale ? channels[ch].scale : 1.0f;
+        float value = handle->values[ch] * scale;
+        uint8_t filtered = 0;
+        
+        // Saturate, casting a float outside the int32 range is undefined
+        int32_t fixed;
+        if (!(value < 2147483648.0f)) {
+            fixed = INT32_MAX;
+        } else if (value <= -2147483648.0f) {
+            fixed = INT32_MIN;
+        } else {
+            fixed = (int32_t)(value + ((value < 0) ? -0.5f : 0.5f));
+        }
+        
+        SensorFilter* filter;
+        for (filter = handle->filters; filter; filter = filter->next) {
+            if (filter->channel != ch) continue;
+            fixed = sensor_filter_run(filter, fixed);
+            filtered = 1;
+        }
+        
+        // Unfiltered channel keeps full driver resolution
+        if (filtered) handle->values[ch] = fixed / scale;
+    }
+}
+#endif
+
+#if SENSOR_USE_STATS || SENSOR_USE_REPORT || SENSOR_QUEUE_SIZE > 0
+/**
+  * @brief  All channel values of the sample just read, filtered when filters are attached
+  */
+static SensorResult sensor_sample_values(TempHumiSensor* handle, float* values)
+{
+#if SENSOR_USE_FILTER
+    if (handle->filters) {
+        uint8_t count = sensor_get_channels(handle, NULL);
+        uint8_t ch;
+        for (ch = 0; ch < count; ch++) {
+            values[ch] = handle->values[ch];
+        }
+        return SENSOR_OK;
+    }
+#endif
+    return sensor_driver_values(handle, values);
+}
+#endif
+
+#if SENSOR_USE_STATS
+/**
+  * @brief  Add new sample to attached statistics windows
+  */
+static void sensor_stats_feed(TempHumiSensor* handle)
+{
+    if (!handle->stats) return;
+    
+    float values[SENSOR_CHANNEL_MAX];
+    if (sensor_sample_values(handle, values) != SENSOR_OK) return;
+    
+    SensorStats* stats;
+    for (stats = handle->stats; stats; stats = stats->next) {
+        sensor_stats_add(stats, values[stats->channel]);
+    }
+}
+#endif
+
+#if SENSOR_USE_REPORT
+/**
+  * @brief  Publish new sample if it left the deadband or heartbeat expired
+  */
+static void sensor_report(TempHumiSensor* handle)
+{
+    SensorSample sample = { 0 };
+    handle->publish_last = 0;
+    if (sensor_sample_values(handle, sample.values) != SENSOR_OK) return;
+    sample.timestamp = sensor_now();
+    
+    if (handle->has_published) {
+        // Any channel leaving its deadband publishes the whole sample
+        uint8_t count = sensor_get_channels(handle, NULL);
+        uint8_t changed = 0;
+        uint8_t ch;
+        for (ch = 0; ch < count && !changed; ch++) {
+            float delta = sample.values[ch] - handle->published.values[ch];
+            if (delta < 0) delta = -delta;
+            changed = (delta >= handle->deadband[ch]);
+        }
+        
+        uint8_t expired = handle->heartbeat &&
+                          (sample.timestamp - handle->published.timestamp >= handle->heartbeat);
+        if (!changed && !expired) {
+            handle->suppressed++;
+            return;
+        }
+    }
+    
+    handle->published = sample;
+    handle->has_published = 1;
+    handle->publish_last = 1;
+    if (handle->publish) {
+        handle->publish(handle, &sample);
+    }
+}
+#endif
+
+#if SENSOR_QUEUE_SIZE > 0
+/**
+  * @brief  Store last sample in queue, drop it when queue is full
+  */
+static void sensor_queue_push(TempHumiSensor* handle)
+{
+    uint8_t head = handle->queue_head;
+    uint8_t next = (head + 1 < SENSOR_QUEUE_SIZE) ? (head + 1) : 0;
+    
+    if (next == handle->queue_tail) {
+        handle->queue_overrun++;
+        return;
+    }
+    
+    SensorSample* sample = &handle->queue[head];
+    memset(sample, 0, sizeof(SensorSample));
+    if (sensor_sample_values(handle, sample->values) != SENSOR_OK) return;
+    sample->timestamp = sensor_now();
+    
+    SENSOR_BARRIER();
+    handle->queue_head = next;
+}
+#endif
+
+/**
+  * @brief  Set next deadline delay ms from now (at least one tick for 0)
+  */
+static void sensor_schedule(TempHumiSensor* handle, uint32_t delay)
+{
+    sensor_schedule_at(handle, sensor_now() + (delay ? delay : 1));
+}
+
+/**
+  * @brief  Set next deadline (ms)
+  */
+static void sensor_schedule_at(TempHumiSensor* handle, uint32_t deadline)
+{
+    if (!handle->slot) return;
+    
+    // Remember the delay so the next run knows how much time passed
+    uint32_t delay = deadline - sensor_now();
+    handle->delay = ((int32_t)delay < 0) ? 0 : (delay > 0xFFFFu) ? 0xFFFFu : (uint16_t)delay;
+    handle->deadline = deadline;
+    handle->parked = 0;
+    sensor_heap_fix(handle->slot - 1);
+}
+
+/**
+  * @brief  Move sensor behind all deadlines until scheduled again
+  */
+static void sensor_park(TempHumiSensor* handle)
+{
+    if (!handle->slot) return;
+    
+    handle->parked = 1;
+    sensor_heap_fix(handle->slot - 1);
+}
+
+/**
+  * @brief  Heap order - earlier deadline first, parked sensors last
+  */
+static uint8_t sensor_heap_less(const TempHumiSensor* a, const TempHumiSensor* b)
+{
+    if (a->parked != b->parked) return b->parked;
+    return (int32_t)(a->deadline - b->deadline) < 0;
+}
+
+/**
+  * @brief  Swap two heap entries, keeping their slots in sync
+  */
+static void sensor_heap_swap(uint8_t i, uint8_t j)
+{
+    TempHumiSensor* tmp = sensor_heap[i];
+    sensor_heap[i] = sensor_heap[j];
+    sensor_heap[j] = tmp;
+    sensor_heap[i]->slot = i + 1;
+    sensor_heap[j]->slot = j + 1;
+}
+
+/**
+  * @brief  Restore heap order after the key at pos changed
+  */
+static void sensor_heap_fix(uint8_t pos)
+{
+    // Sift up
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (!sensor_heap_less(sensor_heap[pos], sensor_heap[parent])) break;
+        sensor_heap_swap(pos, parent);
+        pos = parent;
+    }
+    
+    // Sift down
+    for (;;) {
+        uint8_t child = 2 * pos + 1;
+        if (child >= sensor_count) break;
+        if (child + 1 < sensor_count && sensor_heap_less(sensor_heap[child + 1], sensor_heap[child])) {
+            child++;
+        }
+        if (!sensor_heap_less(sensor_heap[child], sensor_heap[pos])) break;
+        sensor_heap_swap(pos, child);
+        pos = child;
+    }
+}
+
+#if SENSOR_USE_DERIVED
+/**
+  * @brief  Channel 0/1 are temperature/humidity, derived values apply
+  */
+static uint8_t sensor_is_temp_humi(TempHumiSensor* handle)
+{
+    const SensorChannel* channels;
+    if (sensor_get_channels(handle, &channels) < 2) return 0;
+    return channels[SENSOR_CHANNEL_TEMPERATURE].type == SENSOR_CHANNEL_TYPE_TEMPERATURE &&
+           channels[SENSOR_CHANNEL_HUMIDITY].type == SENSOR_CHANNEL_TYPE_HUMIDITY;
+}
+
+/**
+  * @brief  Derived values from float sample (0.01 fixed point inputs)
+  */
+static void sensor_calc_derived(float temp, float humi, SensorDerived* derived)
+{
+    // Clamp before the integer casts, out of range values (and NaN) can't overflow
+    if (!(temp >= SENSOR_DERIVED_TEMP_MIN / 100.0f)) temp = SENSOR_DERIVED_TEMP_MIN / 100.0f;
+    if (temp > SENSOR_DERIVED_TEMP_MAX / 100.0f) temp = SENSOR_DERIVED_TEMP_MAX / 100.0f;
+    if (!(humi > 0.0f)) humi = 0.0f;
+    if (humi > 100.0f) humi = 100.0f;
+    int32_t t = (int32_t)(temp * 100.0f + ((temp < 0) ? -0.5f : 0.5f));
+    int32_t h = (int32_t)(humi * 100.0f + 0.5f);
+    
+    sensor_derived_calc((int16_t)t, (uint16_t)h, derived);
+}
+#endif
+
+#if !SENSOR_COMPACT
+/**
+  * @brief  All channel values of the cached sample, call in a seqlock read section
+  * @note   SENSOR_LAZY: copied from the driver unless sensor_ticks() cached
+  *         them, a driver update meanwhile makes the caller retry
+  */
+static SensorResult sensor_fetch(TempHumiSensor* handle, float* values)
+{
+#if SENSOR_LAZY
+    if (!handle->cached) return sensor_driver_values(handle, values);
+#endif
+    uint8_t ch;
+    for (ch = 0; ch < SENSOR_CHANNEL_MAX; ch++) {
+        values[ch] = handle->values[ch];
+    }
+    return SENSOR_OK;
+}
+
+/**
+  * @brief  Seqlock writer - enter update (seq odd)
+  */
+static void sensor_write_begin(TempHumiSensor* handle)
+{
+    handle->seq++;
+    SENSOR_BARRIER();
+}
+
+/**
+  * @brief  Seqlock writer - publish update (seq even)
+  */
+static void sensor_write_end(TempHumiSensor* handle)
+{
+    SENSOR_BARRIER();
+    handle->seq++;
+}
+
+/**
+  * @brief  Seqlock reader - sequence before copying
+  */
+static uint16_t sensor_read_begin(TempHumiSensor* handle)
+{
+    uint16_t seq = handle->seq;
+    SENSOR_BARRIER();
+    return seq;
+}
+
+/**
+  * @brief  Seqlock reader - copy must be retried if written meanwhile
+  */
+static uint8_t sensor_read_retry(TempHumiSensor* handle, uint16_t seq)
+{
+    SENSOR_BARRIER();
+    return (seq & 1) || (handle->seq != seq);
 }
+#endif
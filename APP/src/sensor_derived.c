@@ -0,0 +1,241 @@
+/*
+ * Derived Psychrometric Values Implementation
+ */
+
+#include "sensor_derived.h"
+
+// Q16 fixed point
+#define SENSOR_Q16_ONE          65536
+
+// Magnus coefficients, b in Q16 and c in 0.01 °C
+#define SENSOR_MAGNUS_B_Q16     1154744     // 17.62
+#define SENSOR_MAGNUS_C_CENTI   24312       // 243.12
+
+#define SENSOR_LN2_Q16          45426       // ln(2)
+#define SENSOR_LOG2E_Q16        94548       // log2(e)
+#define SENSOR_LN10000_Q16      603609      // ln(100 %RH in 0.01 %RH)
+
+// Table segments over one octave, linearly interpolated
+#define SENSOR_TABLE_BITS       5
+#define SENSOR_TABLE_SHIFT      (16 - SENSOR_TABLE_BITS)
+
+// log2(1 + i/32) in Q16
+static const uint32_t sensor_log2_table[33] = {
+        0,  2909,  5732,  8473, 11136, 13727, 16248, 18704,
+    21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+    38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+    52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+    65536
+};
+
+// 2^(i/32) in Q16
+static const uint32_t sensor_exp2_table[33] = {
+     65536,  66971,  68438,  69936,  71468,  73032,  74632,  76266,
+     77936,  79642,  81386,  83169,  84990,  86851,  88752,  90696,
+     92682,  94711,  96785,  98905, 101070, 103283, 105545, 107856,
+    110218, 112631, 115098, 117618, 120194, 122825, 125515, 128263,
+    131072
+};
+
+// Internal helper functions
+static int16_t sensor_clamp_temp(int16_t temp);
+static int32_t sensor_magnus(int16_t temp);
+static int32_t sensor_ln(uint32_t x);
+static int32_t sensor_exp(int32_t x);
+static uint32_t sensor_isqrt(uint32_t x);
+static int32_t sensor_div_round(int64_t num, int64_t den);
+static int16_t sensor_dew_point_magnus(int32_t magnus, uint16_t humi);
+static uint16_t sensor_abs_humidity_magnus(int32_t magnus, int16_t temp, uint16_t humi);
+
+/**
+  * @brief  Dew point (0.01 °C), Magnus formula
+  */
+int16_t sensor_dew_point(int16_t temp, uint16_t humi)
+{
+    temp = sensor_clamp_temp(temp);
+    return sensor_dew_point_magnus(sensor_magnus(temp), humi);
+}
+
+/**
+  * @brief  Absolute humidity (0.01 g/m³), saturates at 655.35 g/m³
+  */
+uint16_t sensor_abs_humidity(int16_t temp, uint16_t humi)
+{
+    temp = sensor_clamp_temp(temp);
+    return sensor_abs_humidity_magnus(sensor_magnus(temp), temp, humi);
+}
+
+/**
+  * @brief  Heat index (0.01 °C), NWS procedure
+  * @note   Steadman's simple formula below 80 °F, Rothfusz regression
+  *         with low/high humidity adjustments above
+  */
+int16_t sensor_heat_index(int16_t temp, uint16_t humi)
+{
+    // Work in 0.01 °F and 0.01 %RH like the published coefficients
+    temp = sensor_clamp_temp(temp);
+    int32_t t = sensor_div_round((int64_t)temp * 9, 5) + 3200;
+    int32_t r = (humi > 10000) ? 10000 : humi;
+    
+    int32_t hi = (t + 6100 + (t - 6800) * 12 / 10 + r * 94 / 1000) / 2;
+    
+    if ((hi + t) / 2 >= 8000) {
+        // Each term scaled to 0.01 °F, coefficients in 1e-8
+        int64_t t2 = (int64_t)t * t / 100;
+        int64_t r2 = (int64_t)r * r / 100;
+        int64_t sum = -4237900000LL * 100
+                    + 204901523LL * t
+                    + 1014333127LL * r
+                    - 22475541LL * ((int64_t)t * r / 100)
+                    - 683783LL * t2
+                    - 5481717LL * r2
+                    + 122874LL * (t2 * r / 100)
+                    + 85282LL * (t * r2 / 100)
+                    - 199LL * (t2 * r2 / 100);
+        hi = sensor_div_round(sum, 100000000);
+    
+        if (r < 1300 && t >= 8000 && t <= 11200) {
+            // Dry air: subtract ((13 - RH) / 4) * sqrt((17 - |T - 95|) / 17)
+            int32_t d = (t > 9500) ? (t - 9500) : (9500 - t);
+            uint32_t s = sensor_isqrt((uint32_t)((1700 - d) * 16384 / 1700) << 14);
+            hi -= (int32_t)(((uint32_t)(1300 - r) * s) >> 16);
+        } else if (r > 8500 && t >= 8000 && t <= 8700) {
+            // Humid air: add ((RH - 85) / 10) * ((87 - T) / 5)
+            hi += (r - 8500) * (8700 - t) / 5000;
+        }
+    }
+    
+    int32_t result = sensor_div_round((int64_t)(hi - 3200) * 5, 9);
+    return (result > INT16_MAX) ? INT16_MAX : (int16_t)result;
+}
+
+/**
+  * @brief  Calculate all derived values
+  */
+void sensor_derived_calc(int16_t temp, uint16_t humi, SensorDerived* out)
+{
+    if (!out) return;
+    
+    temp = sensor_clamp_temp(temp);
+    int32_t magnus = sensor_magnus(temp);
+    out->dew_point = sensor_dew_point_magnus(magnus, humi);
+    out->abs_humidity = sensor_abs_humidity_magnus(magnus, temp, humi);
+    out->heat_index = sensor_heat_index(temp, humi);
+}
+
+// ========== Internal Functions ==========
+
+/**
+  * @brief  Limit temperature to the supported input range
+  */
+static int16_t sensor_clamp_temp(int16_t temp)
+{
+    if (temp < SENSOR_DERIVED_TEMP_MIN) return SENSOR_DERIVED_TEMP_MIN;
+    if (temp > SENSOR_DERIVED_TEMP_MAX) return SENSOR_DERIVED_TEMP_MAX;
+    return temp;
+}
+
+/**
+  * @brief  Magnus term b*T/(c+T) in Q16, T within the clamped range
+  */
+static int32_t sensor_magnus(int16_t temp)
+{
+    return sensor_div_round((int64_t)temp * SENSOR_MAGNUS_B_Q16, SENSOR_MAGNUS_C_CENTI + temp);
+}
+
+/**
+  * @brief  Dew point from precomputed Magnus term
+  */
+static int16_t sensor_dew_point_magnus(int32_t magnus, uint16_t humi)
+{
+    if (humi == 0) humi = 1;            // ln(0), 0.01 %RH is the resolution
+    if (humi > 10000) humi = 10000;
+    
+    // gamma = ln(RH / 100 %) + b*T/(c+T)
+    int32_t gamma = sensor_ln(humi) - SENSOR_LN10000_Q16 + magnus;
+    return (int16_t)sensor_div_round((int64_t)SENSOR_MAGNUS_C_CENTI * gamma,
+                                     SENSOR_MAGNUS_B_Q16 - gamma);
+}
+
+/**
+  * @brief  Absolute humidity from precomputed Magnus term
+  * @note   AH = 6.112 hPa * exp(b*T/(c+T)) * RH * 2.1674 / (273.15 + T)
+  */
+static uint16_t sensor_abs_humidity_magnus(int32_t magnus, int16_t temp, uint16_t humi)
+{
+    if (humi > 10000) humi = 10000;
+    
+    int64_t num = (int64_t)sensor_exp(magnus) * humi * 1324715;   // 6.112 * 2.1674 * 1e5
+    int64_t den = (int64_t)(temp + 27315) * SENSOR_Q16_ONE * 1000;
+    int32_t ah = sensor_div_round(num, den);
+    return (ah > 0xFFFF) ? 0xFFFF : (uint16_t)ah;
+}
+
+/**
+  * @brief  Natural logarithm of integer x >= 1, Q16 result
+  */
+static int32_t sensor_ln(uint32_t x)
+{
+    // Normalize to mantissa 1.m in Q16
+    int32_t exponent = 31;
+    while (!(x & 0x80000000u)) {
+        x <<= 1;
+        exponent--;
+    }
+    uint32_t m = (x >> 15) & 0xFFFF;
+    
+    uint32_t i = m >> SENSOR_TABLE_SHIFT;
+    uint32_t w = m & ((1u << SENSOR_TABLE_SHIFT) - 1);
+    int32_t frac = sensor_log2_table[i] +
+                   (int32_t)(((sensor_log2_table[i + 1] - sensor_log2_table[i]) * w) >> SENSOR_TABLE_SHIFT);
+    
+    int32_t log2 = exponent * SENSOR_Q16_ONE + frac;
+    return (int32_t)(((int64_t)log2 * SENSOR_LN2_Q16) >> 16);
+}
+
+/**
+  * @brief  e^x for Q16 x in [-16, 15), Q16 result
+  */
+static int32_t sensor_exp(int32_t x)
+{
+    // e^x = 2^(x * log2(e)), offset keeps the shift on a non-negative value
+    int64_t y = (((int64_t)x * SENSOR_LOG2E_Q16) >> 16) + (32LL << 16);
+    int32_t exponent = (int32_t)(y >> 16) - 32;
+    uint32_t f = (uint32_t)y & 0xFFFF;
+    
+    uint32_t i = f >> SENSOR_TABLE_SHIFT;
+    uint32_t w = f & ((1u << SENSOR_TABLE_SHIFT) - 1);
+    uint32_t m = sensor_exp2_table[i] +
+                 (((sensor_exp2_table[i + 1] - sensor_exp2_table[i]) * w) >> SENSOR_TABLE_SHIFT);
+    
+    return (exponent >= 0) ? (int32_t)(m << exponent) : (int32_t)(m >> -exponent);
+}
+
+/**
+  * @brief  Integer square root
+  */
+static uint32_t sensor_isqrt(uint32_t x)
+{
+    uint32_t result = 0;
+    uint32_t bit = 1u << 30;
+    
+    while (bit > x) bit >>= 2;
+    while (bit) {
+        if (x >= result + bit) {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+/**
+  * @brief  Division rounded to nearest, den > 0
+  */
+static int32_t sensor_div_round(int64_t num, int64_t den)
+{
+    return (int32_t)((num >= 0) ? (num + den / 2) / den : (num - den / 2) / den);
+}
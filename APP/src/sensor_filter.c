@@ -0,0 +1,145 @@
+/*
+ * Fixed-point Sample Filters Implementation
+ */
+
+#include "sensor_filter.h"
+#include <string.h>
+
+// Internal helper functions
+static void sensor_filter_setup(SensorFilter* filter, SensorFilterType type);
+static int32_t sensor_filter_window(SensorFilter* filter, int32_t value);
+static int32_t sensor_filter_median_of(const SensorFilter* filter);
+
+/**
+  * @brief  First-order IIR stage, alpha = 1 / 2^shift (shift 1..15)
+  */
+void sensor_filter_iir(SensorFilter* filter, uint8_t shift)
+{
+    if (!filter || shift == 0 || shift > 15) return;
+    
+    sensor_filter_setup(filter, SENSOR_FILTER_IIR);
+    filter->shift = shift;
+}
+
+/**
+  * @brief  Moving average stage over length samples
+  */
+void sensor_filter_average(SensorFilter* filter, int32_t* window, uint8_t length)
+{
+    if (!filter || !window || length == 0) return;
+    
+    sensor_filter_setup(filter, SENSOR_FILTER_AVERAGE);
+    filter->window = window;
+    filter->length = length;
+}
+
+/**
+  * @brief  Median stage over length samples (up to SENSOR_FILTER_MEDIAN_MAX)
+  */
+void sensor_filter_median(SensorFilter* filter, int32_t* window, uint8_t length)
+{
+    if (!filter || !window || length == 0 || length > SENSOR_FILTER_MEDIAN_MAX) return;
+    
+    sensor_filter_setup(filter, SENSOR_FILTER_MEDIAN);
+    filter->window = window;
+    filter->length = length;
+}
+
+/**
+  * @brief  Forget filter history, next sample starts over
+  */
+void sensor_filter_reset(SensorFilter* filter)
+{
+    if (!filter) return;
+    
+    filter->count = 0;
+    filter->head = 0;
+    filter->acc = 0;
+}
+
+/**
+  * @brief  Feed sample through one stage
+  */
+int32_t sensor_filter_run(SensorFilter* filter, int32_t value)
+{
+    if (!filter) return value;
+    
+    switch (filter->type) {
+    case SENSOR_FILTER_IIR:
+        // Q16 state so small steps don't stall, first sample seeds it
+        if (!filter->count) {
+            filter->acc = (int64_t)value * (1 << SENSOR_FILTER_IIR_FRAC);
+            filter->count = 1;
+        } else {
+            filter->acc += ((int64_t)value * (1 << SENSOR_FILTER_IIR_FRAC) - filter->acc) / (1 << filter->shift);
+        }
+        return (int32_t)((filter->acc + ((filter->acc < 0) ? -(1 << (SENSOR_FILTER_IIR_FRAC - 1))
+                                                            : (1 << (SENSOR_FILTER_IIR_FRAC - 1))))
+                         / (1 << SENSOR_FILTER_IIR_FRAC));
+    
+    case SENSOR_FILTER_AVERAGE:
+        sensor_filter_window(filter, value);
+        return (int32_t)((filter->acc + ((filter->acc < 0) ? -(filter->count / 2) : (filter->count / 2)))
+                         / filter->count);
+    
+    case SENSOR_FILTER_MEDIAN:
+        sensor_filter_window(filter, value);
+        return sensor_filter_median_of(filter);
+    
+    default:
+        return value;
+    }
+}
+
+// ========== Internal Functions ==========
+
+/**
+  * @brief  Clear stage, keep chaining
+  */
+static void sensor_filter_setup(SensorFilter* filter, SensorFilterType type)
+{
+    uint8_t channel = filter->channel;
+    SensorFilter* next = filter->next;
+    
+    memset(filter, 0, sizeof(SensorFilter));
+    filter->type = type;
+    filter->channel = channel;
+    filter->next = next;
+}
+
+/**
+  * @brief  Insert sample into window ring, keep running sum
+  */
+static int32_t sensor_filter_window(SensorFilter* filter, int32_t value)
+{
+    if (filter->count < filter->length) {
+        filter->count++;
+    } else {
+        filter->acc -= filter->window[filter->head];
+    }
+    
+    filter->window[filter->head] = value;
+    filter->acc += value;
+    filter->head = (filter->head + 1 < filter->length) ? (filter->head + 1) : 0;
+    return value;
+}
+
+/**
+  * @brief  Median of window (lower median for even count)
+  */
+static int32_t sensor_filter_median_of(const SensorFilter* filter)
+{
+    int32_t sorted[SENSOR_FILTER_MEDIAN_MAX];
+    
+    // Insertion sort, window is small
+    for (uint8_t i = 0; i < filter->count; i++) {
+        int32_t v = filter->window[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    return sorted[(filter->count - 1) / 2];
+}
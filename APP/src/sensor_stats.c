@@ -0,0 +1,155 @@
+/*
+ * Sliding Window Statistics Implementation
+ */
+
+#include "sensor_stats.h"
+#include <string.h>
+
+// Internal helper functions
+static uint16_t sensor_stats_wrap(const SensorStats* stats, uint32_t index);
+static void sensor_stats_anchor(SensorStats* stats);
+static void sensor_stats_push(SensorStats* stats, uint16_t* deque, uint16_t* first,
+                              uint16_t* count, uint16_t slot, float value, uint8_t is_min);
+
+/**
+  * @brief  Initialize window with caller storage
+  * @param  values: capacity entries
+  * @param  deque: 2 * capacity entries (min and max deque)
+  */
+void sensor_stats_init(SensorStats* stats, float* values, uint16_t* deque, uint16_t capacity)
+{
+    if (!stats || !values || !deque || capacity == 0) return;
+    
+    memset(stats, 0, sizeof(SensorStats));
+    stats->values = values;
+    stats->min_deque = deque;
+    stats->max_deque = deque + capacity;
+    stats->capacity = capacity;
+}
+
+/**
+  * @brief  Drop all samples, keep storage
+  */
+void sensor_stats_reset(SensorStats* stats)
+{
+    if (!stats) return;
+    
+    stats->count = 0;
+    stats->head = 0;
+    stats->min_first = stats->min_count = 0;
+    stats->max_first = stats->max_count = 0;
+    stats->mean = 0.0f;
+    stats->m2 = 0.0f;
+}
+
+/**
+  * @brief  Add sample, evicting the oldest one when the window is full
+  */
+void sensor_stats_add(SensorStats* stats, float value)
+{
+    if (!stats || !stats->capacity) return;
+    
+    uint16_t slot = stats->head;
+    
+    if (stats->count < stats->capacity) {
+        // Growing window - Welford update
+        stats->count++;
+        float delta = value - stats->mean;
+        stats->mean += delta / stats->count;
+        stats->m2 += delta * (value - stats->mean);
+    } else {
+        // Full window - replace oldest sample in the moments
+        float old = stats->values[slot];
+        float old_mean = stats->mean;
+        stats->mean += (value - old) / stats->count;
+        stats->m2 += (value - old) * (value - stats->mean + old - old_mean);
+        if (stats->m2 < 0.0f) stats->m2 = 0.0f;     // rounding
+    
+        // Oldest sample leaves the deques
+        if (stats->min_count && stats->min_deque[stats->min_first] == slot) {
+            stats->min_first = sensor_stats_wrap(stats, stats->min_first + 1u);
+            stats->min_count--;
+        }
+        if (stats->max_count && stats->max_deque[stats->max_first] == slot) {
+            stats->max_first = sensor_stats_wrap(stats, stats->max_first + 1u);
+            stats->max_count--;
+        }
+    }
+    
+    stats->values[slot] = value;
+    sensor_stats_push(stats, stats->min_deque, &stats->min_first, &stats->min_count, slot, value, 1);
+    sensor_stats_push(stats, stats->max_deque, &stats->max_first, &stats->max_count, slot, value, 0);
+    stats->head = sensor_stats_wrap(stats, slot + 1u);
+    
+    // Full window turned over once - drop the rounding of the updates
+    if (stats->count == stats->capacity && stats->head == 0) {
+        sensor_stats_anchor(stats);
+    }
+}
+
+/**
+  * @brief  Get window statistics
+  */
+void sensor_stats_get(const SensorStats* stats, SensorStatsResult* result)
+{
+    if (!stats || !result) return;
+    
+    memset(result, 0, sizeof(SensorStatsResult));
+    if (!stats->count) return;
+    
+    result->count = stats->count;
+    result->mean = stats->mean;
+    result->variance = stats->m2 / stats->count;
+    result->min = stats->values[stats->min_deque[stats->min_first]];
+    result->max = stats->values[stats->max_deque[stats->max_first]];
+}
+
+// ========== Internal Functions ==========
+
+/**
+  * @brief  Wrap ring/deque index
+  */
+static uint16_t sensor_stats_wrap(const SensorStats* stats, uint32_t index)
+{
+    return (index >= stats->capacity) ? (uint16_t)(index - stats->capacity) : (uint16_t)index;
+}
+
+/**
+  * @brief  Recompute mean and m2 from the window (two passes)
+  * @note   Deviations from the first sample are summed, so large offsets
+  *         (e.g. pressure in Pa) don't cost float precision
+  */
+static void sensor_stats_anchor(SensorStats* stats)
+{
+    float ref = stats->values[0];
+    float sum = 0.0f;
+    uint16_t i;
+    for (i = 0; i < stats->count; i++) {
+        sum += stats->values[i] - ref;
+    }
+    stats->mean = ref + sum / stats->count;
+    
+    float m2 = 0.0f;
+    for (i = 0; i < stats->count; i++) {
+        float d = stats->values[i] - stats->mean;
+        m2 += d * d;
+    }
+    stats->m2 = m2;
+}
+
+/**
+  * @brief  Append slot to monotonic deque, dropping entries it dominates
+  */
+static void sensor_stats_push(SensorStats* stats, uint16_t* deque, uint16_t* first,
+                              uint16_t* count, uint16_t slot, float value, uint8_t is_min)
+{
+    while (*count) {
+        uint16_t last = sensor_stats_wrap(stats, (uint32_t)*first + *count - 1u);
+        float v = stats->values[deque[last]];
+        if (is_min ? (v < value) : (v > value)) break;
+        (*count)--;
+    }
+    
+    deque[sensor_stats_wrap(stats, (uint32_t)*first + *count)] = slot;
+    (*count)++;
+}
@@ -0,0 +1,168 @@
+/*
+ * AHT21 Adapter for Sensor Abstract Layer
+ * Bridges AHT21 driver to generic sensor interface; the adapter functions
+ * are inline here so a static-dispatch build (SENSOR_STATIC_OPS) calls
+ * them without going through the ops table
+ */
+
+#ifndef __TEMP_HUMI_ADAPTER_H__
+#define __TEMP_HUMI_ADAPTER_H__
+
+#include "sensor_temp_humi.h"
+#include "aht21.h"
+
+// Adapter functions
+static inline SensorResult aht21_adapter_init(void* handle)
+{
+    // AHT21 already initialized externally (aht21_init or aht21_init_async),
+    // can do additional checks here
+    (void)handle;
+    return SENSOR_OK;
+}
+
+static inline SensorResult aht21_adapter_reset(void* handle)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    return (aht21_soft_reset(aht21) == AHT21_OK) ? SENSOR_OK : SENSOR_ERR_COMM;
+}
+
+static inline SensorResult aht21_adapter_trigger(void* handle)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    AHT21_Result result = aht21_trigger_measure(aht21);
+    
+    if (result == AHT21_OK) return SENSOR_OK;
+    if (result == AHT21_ERR_BUSY) return SENSOR_ERR_BUSY;
+    return SENSOR_ERR_COMM;
+}
+
+static inline SensorResult aht21_adapter_read(void* handle)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    AHT21_Result result = aht21_read_data(aht21);
+    
+    if (result == AHT21_OK) return SENSOR_OK;
+    if (result == AHT21_ERR_BUSY) return SENSOR_ERR_BUSY;
+    return SENSOR_ERR_COMM;
+}
+
+static inline SensorResult aht21_adapter_get_temp(void* handle, float* temp)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    return (aht21_get_temperature(aht21, temp) == AHT21_OK) ? SENSOR_OK : SENSOR_ERR_NOT_READY;
+}
+
+static inline SensorResult aht21_adapter_get_humi(void* handle, float* humi)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    return (aht21_get_humidity(aht21, humi) == AHT21_OK) ? SENSOR_OK : SENSOR_ERR_NOT_READY;
+}
+
+static inline SensorResult aht21_adapter_get_values(void* handle, float* values, uint8_t count)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    
+    if (count < 2 ||
+        aht21_get_temperature(aht21, &values[SENSOR_CHANNEL_TEMPERATURE]) != AHT21_OK ||
+        aht21_get_humidity(aht21, &values[SENSOR_CHANNEL_HUMIDITY]) != AHT21_OK) {
+        return SENSOR_ERR_NOT_READY;
+    }
+    return SENSOR_OK;
+}
+
+static inline SensorResult aht21_adapter_get_time(void* handle, uint32_t* trigger, uint32_t* complete)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    return (aht21_get_timestamps(aht21, trigger, complete) == AHT21_OK) ? SENSOR_OK : SENSOR_ERR_NOT_READY;
+}
+
+static inline uint32_t aht21_adapter_read_wait(void* handle)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    return aht21_read_wait(aht21);
+}
+
+static inline uint8_t aht21_adapter_get_conversions(void* handle)
+{
+#if AHT21_USE_OVERSAMPLING
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    return aht21->os_ratio;
+#else
+    (void)handle;
+    return 1;
+#endif
+}
+
+static inline SensorState aht21_adapter_get_state(void* handle)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    
+    switch (aht21->state) {
+        case AHT21_STATE_IDLE: return SENSOR_STATE_IDLE;
+        case AHT21_STATE_WAIT_MEASURE: return SENSOR_STATE_MEASURING;
+        case AHT21_STATE_READY: return SENSOR_STATE_READY;
+        case AHT21_STATE_ERROR:
+        case AHT21_STATE_OFFLINE: return SENSOR_STATE_ERROR;
+        case AHT21_STATE_POWER_UP:
+        case AHT21_STATE_INIT:
+        case AHT21_STATE_RESET: return SENSOR_STATE_INIT;
+        default: return SENSOR_STATE_IDLE;
+    }
+}
+
+static inline uint32_t aht21_adapter_poll(void* handle, uint32_t elapsed_ms)
+{
+    AHT21_Handle* aht21 = (AHT21_Handle*)handle;
+    
+    // Only power-up/reset and error recovery (back-off) are advanced here,
+    // measurements are driven by the sensor layer
+    switch (aht21->state) {
+        case AHT21_STATE_POWER_UP:
+        case AHT21_STATE_INIT:
+        case AHT21_STATE_RESET:
+        case AHT21_STATE_ERROR:
+        case AHT21_STATE_OFFLINE:
+            aht21_ticks_elapsed(aht21, elapsed_ms / AHT21_TICK_INTERVAL);
+            return aht21_next_wakeup(aht21) * AHT21_TICK_INTERVAL;
+        default:
+            return 0;
+    }
+}
+
+// AHT21 channels
+static const SensorChannel aht21_channels[] = {
+    { SENSOR_CHANNEL_TYPE_TEMPERATURE, "°C", 100 },
+    { SENSOR_CHANNEL_TYPE_HUMIDITY, "%RH", 100 }
+};
+
+// AHT21 operation function set initializer
+#define AHT21_ADAPTER_OPS {                           \
+    .init = aht21_adapter_init,                       \
+    .reset = aht21_adapter_reset,                     \
+    .trigger = aht21_adapter_trigger,                 \
+    .read = aht21_adapter_read,                       \
+    .get_temp = aht21_adapter_get_temp,               \
+    .get_humi = aht21_adapter_get_humi,               \
+    .get_time = aht21_adapter_get_time,               \
+    .get_state = aht21_adapter_get_state,             \
+    .poll = aht21_adapter_poll,                       \
+    .read_wait = aht21_adapter_read_wait,             \
+    .get_conversions = aht21_adapter_get_conversions, \
+    .get_values = aht21_adapter_get_values,           \
+    .measure_time = AHT21_MEASURE_TIME,               \
+    .channels = aht21_channels,                       \
+    .channel_count = 2                                \
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AHT21 operation function set (temp_humi_adapter.c)
+extern const SensorOps aht21_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TEMP_HUMI_ADAPTER_H__
@@ -8,6 +8,15 @@
 
 #include "iic_abstract.h"
 
+// Multiplexer support (several AHT21 on one bus), 0 disables
+#ifndef AHT21_USE_MUX
+#define AHT21_USE_MUX           0
+#endif
+
+#if AHT21_USE_MUX
+#include "iic_mux.h"
+#endif
+
 // AHT21 I2C address
 #define AHT21_ADDR              0x38
 
@@ -20,13 +29,102 @@
 #define AHT21_STATUS_BUSY       0x80
 #define AHT21_STATUS_CALIBRATED 0x08
 
+// AHT21 measurement frame: status, 20-bit humidity, 20-bit temperature, CRC8
+#define AHT21_FRAME_SIZE        7
+
+// AHT21 timing (ms)
+#define AHT21_POWER_UP_TIME     40      // power-up stabilization
+#define AHT21_INIT_TIME         10      // calibration after init command
+#define AHT21_RESET_TIME        20      // soft reset (upper bound)
+#define AHT21_RESET_POLL        2       // status poll interval during soft reset
+#define AHT21_MEASURE_TIME      80      // measurement conversion
+#define AHT21_FRESH_POLL        10      // status poll interval of blocking reads
+
+// Error recovery: reset back-off doubles from MIN up to MAX (ms),
+// after RETRY_MAX failed attempts the handle goes offline and only
+// probes the bus every PROBE_INTERVAL (ms)
+#ifndef AHT21_BACKOFF_MIN
+#define AHT21_BACKOFF_MIN       20
+#endif
+#ifndef AHT21_BACKOFF_MAX
+#define AHT21_BACKOFF_MAX       1000
+#endif
+#ifndef AHT21_RETRY_MAX
+#define AHT21_RETRY_MAX         5
+#endif
+#ifndef AHT21_PROBE_INTERVAL
+#define AHT21_PROBE_INTERVAL    5000
+#endif
+
+// aht21_ticks() call interval (ms)
+#ifndef AHT21_TICK_INTERVAL
+#define AHT21_TICK_INTERVAL     5
+#endif
+
+// Raw sample ring size per handle, 0 disables (max 255)
+#ifndef AHT21_RING_SIZE
+#define AHT21_RING_SIZE         0
+#endif
+
+// Orders ring slot accesses against the head/tail updates (compiler
+// barrier), override with a memory barrier (__DMB()) when aht21_ticks()
+// and the consumer run on different cores
+#ifndef AHT21_BARRIER
+#if defined(__GNUC__)
+#define AHT21_BARRIER()         __asm volatile ("" ::: "memory")
+#else
+#define AHT21_BARRIER()
+#endif
+#endif
+
+// Oversampling: average N back-to-back conversions in the code domain, 0 disables
+#ifndef AHT21_USE_OVERSAMPLING
+#define AHT21_USE_OVERSAMPLING  0
+#endif
+#ifndef AHT21_OVERSAMPLE_MAX
+#define AHT21_OVERSAMPLE_MAX    64      // keeps 20-bit code sums within 32 bits
+#endif
+
+// Event callbacks (aht21_attach()), 0 disables
+#ifndef AHT21_USE_EVENTS
+#define AHT21_USE_EVENTS        0
+#endif
+
+// Trigger/completion timestamps per sample (aht21_get_timestamps(),
+// aht21_read_fresh() sample age, ring sample time), 0 disables
+#ifndef AHT21_USE_TIMESTAMPS
+#define AHT21_USE_TIMESTAMPS    0
+#endif
+
+// Compact handle layout for many instances: packed raw codes, 16-bit
+// counters, state in bitfield, values converted on demand by getters,
+// one callback shared by the attached events, timestamps need aht21_set_clock()
+#ifndef AHT21_COMPACT
+#define AHT21_COMPACT           0
+#endif
+
+// Keep raw codes per sample, getters convert on every access and write
+// nothing back (like the compact layout), for sparse consumption
+#ifndef AHT21_LAZY_CONVERT
+#define AHT21_LAZY_CONVERT      0
+#endif
+
+#if AHT21_COMPACT && AHT21_RETRY_MAX > 7
+#error "AHT21_RETRY_MAX must fit in 3 bits with AHT21_COMPACT"
+#endif
+
+#define AHT21_MS_TO_TICKS(ms)   (((ms) + AHT21_TICK_INTERVAL - 1u) / AHT21_TICK_INTERVAL)
+
 // AHT21 state enumeration
 typedef enum {
     AHT21_STATE_IDLE = 0,       // idle state
     AHT21_STATE_INIT,           // initialization state
     AHT21_STATE_WAIT_MEASURE,   // waiting for measurement
     AHT21_STATE_READY,          // data ready
-    AHT21_STATE_ERROR           // error state
+    AHT21_STATE_ERROR,          // error state
+    AHT21_STATE_POWER_UP,       // waiting for power-up stabilization
+    AHT21_STATE_RESET,          // waiting for soft reset to complete
+    AHT21_STATE_OFFLINE         // retry budget exhausted, probing only
 } AHT21_State;
 
 // AHT21 operation result
@@ -40,22 +138,123 @@ typedef enum {
     AHT21_ERR_CRC
 } AHT21_Result;
 
-// AHT21 handle structure
+// AHT21 events (fired from aht21_ticks)
+typedef enum {
+    AHT21_EVENT_DATA_READY = 0, // new sample parsed
+    AHT21_EVENT_ERROR,          // communication/calibration error
+    AHT21_EVENT_RECOVERED,      // first trigger accepted after error
+    AHT21_EVENT_NUM
+} AHT21_Event;
+
+// Raw sample - 20-bit humidity/temperature codes packed as on the wire
+typedef struct {
+#if AHT21_USE_TIMESTAMPS
+    uint32_t timestamp;         // sample time (ms)
+#endif
+    uint8_t raw[5];             // frame bytes 1..5
+} AHT21_RawSample;
+
+// Converted sample
 typedef struct {
+#if AHT21_USE_TIMESTAMPS
+    uint32_t timestamp;         // sample time (ms)
+#endif
+    float temperature;          // temperature (°C)
+    float humidity;             // humidity (%)
+} AHT21_Sample;
+
+typedef struct _AHT21_Handle AHT21_Handle;
+
+// Monotonic millisecond clock (e.g. HAL_GetTick)
+typedef uint32_t (*AHT21_Clock)(void);
+
+// Event callback (similar to MultiButton's BtnCallback)
+typedef void (*AHT21_Callback)(AHT21_Handle* handle, AHT21_Event event);
+
+// AHT21 handle structure
+struct _AHT21_Handle {
     IIC_Handle* iic;            // IIC handle
+#if AHT21_USE_MUX
+    IIC_Mux* mux;               // multiplexer, NULL if directly attached
+    uint8_t mux_channel;        // multiplexer channel
+#endif
+#if AHT21_COMPACT
+    uint16_t measure_ticks;     // ticks spent in current state
+    uint16_t measure_interval;  // measurement interval (ms)
+    uint8_t raw[5];             // packed 20-bit humidity/temperature codes
+    uint8_t sample_seq;         // completed samples (wraps, 0 = none yet)
+    uint8_t state : 4;          // current state (AHT21_State)
+    uint8_t in_error : 1;       // error reported, waiting for recovery
+    uint8_t retry_count : 3;    // reset attempts since last good sample
+#if AHT21_USE_EVENTS
+    uint8_t cb_events;          // events delivered to cb (bit per AHT21_Event)
+#endif
+    
+#if AHT21_USE_TIMESTAMPS
+    // Timestamps (ms) - aht21_set_clock() clock, 0 without
+    uint32_t trigger_time;      // last sample measurement triggered
+    uint32_t sample_time;       // last sample completed
+#endif
+    
+#if AHT21_USE_EVENTS
+    // Event notification
+    AHT21_Callback cb;          // shared by all attached events
+#endif
+#else
     AHT21_State state;          // current state
-    uint32_t measure_ticks;     // measurement timer
+    uint32_t measure_ticks;     // ticks spent in current state
     
     // Raw data
     uint8_t raw_data[7];        // raw read data
     
+    // Error recovery (fills the frame padding)
+    uint8_t in_error;           // error reported, waiting for recovery
+    uint8_t retry_count;        // reset attempts since last good sample
+    uint8_t sample_seq;         // completed samples (wraps, 0 = none yet)
+    
+    // Configuration
+    uint16_t measure_interval;  // measurement interval (ms)
+    
+#if !AHT21_LAZY_CONVERT
     // Parsed data
     float temperature;          // temperature (°C)
     float humidity;             // humidity (%)
+#endif
     
-    // Configuration
-    uint16_t measure_interval;  // measurement interval (ms)
-} AHT21_Handle;
+#if AHT21_USE_TIMESTAMPS
+    // Timestamps (ms) - aht21_set_clock() clock, driver ticks otherwise
+    uint32_t uptime_ticks;      // ticks since init
+    uint32_t trigger_time;      // last sample measurement triggered
+    uint32_t sample_time;       // last sample completed
+#endif
+    
+#if AHT21_USE_EVENTS
+    // Event notification
+    AHT21_Callback cb[AHT21_EVENT_NUM];
+#endif
+#endif
+    
+#if AHT21_USE_OVERSAMPLING
+    // Oversampling - 20-bit codes accumulated over os_ratio conversions
+    uint8_t os_ratio;           // conversions per sample (1 = off)
+    uint8_t os_count;           // conversions accumulated
+    uint8_t os_restarted;       // last read accumulated and started the next conversion
+    uint32_t os_humi_sum;
+    uint32_t os_temp_sum;
+    uint32_t os_humi_min, os_humi_max;
+    uint32_t os_temp_min, os_temp_max;
+    uint32_t humi_spread;       // max - min codes of last sample
+    uint32_t temp_spread;
+#endif
+    
+#if AHT21_RING_SIZE > 0
+    // Raw sample ring - written by aht21_read_data(), drained by consumer
+    volatile uint8_t ring_head; // next write slot (producer)
+    volatile uint8_t ring_tail; // next read slot (consumer)
+    uint16_t ring_overrun;      // samples dropped on full ring
+    AHT21_RawSample ring[AHT21_RING_SIZE];
+#endif
+};
 
 #ifdef __cplusplus
 extern "C" {
@@ -64,17 +263,77 @@ extern "C" {
 // API functions
 AHT21_Result aht21_init(AHT21_Handle* handle, IIC_Handle* iic);
 AHT21_Result aht21_soft_reset(AHT21_Handle* handle);
+
+// Non-blocking variants - completed by aht21_ticks()
+AHT21_Result aht21_init_async(AHT21_Handle* handle, IIC_Handle* iic);
+AHT21_Result aht21_soft_reset_async(AHT21_Handle* handle);
+
+#if AHT21_USE_MUX
+// Sensor behind IIC multiplexer channel
+AHT21_Result aht21_init_mux(AHT21_Handle* handle, IIC_Mux* mux, uint8_t channel);
+AHT21_Result aht21_init_mux_async(AHT21_Handle* handle, IIC_Mux* mux, uint8_t channel);
+#endif
+
 AHT21_Result aht21_trigger_measure(AHT21_Handle* handle);
 AHT21_Result aht21_read_data(AHT21_Handle* handle);
 AHT21_Result aht21_get_temperature(AHT21_Handle* handle, float* temp);
 AHT21_Result aht21_get_humidity(AHT21_Handle* handle, float* humi);
+AHT21_Result aht21_get_timestamps(AHT21_Handle* handle, uint32_t* trigger, uint32_t* complete);
+
+// After aht21_read_data() returned AHT21_ERR_BUSY: ms until the conversion in
+// flight can be read (oversampling started the next one), 0 = sensor still busy
+uint32_t aht21_read_wait(AHT21_Handle* handle);
+
+#if AHT21_USE_TIMESTAMPS
+// Timestamp clock shared by all handles, NULL falls back to driver ticks
+// (compact layout: no timestamps, aht21_get_timestamps() fails)
+void aht21_set_clock(AHT21_Clock clock);
+#endif
+
+#if AHT21_USE_OVERSAMPLING
+// Oversampling - mean of ratio conversions, spread is max - min
+AHT21_Result aht21_set_oversampling(AHT21_Handle* handle, uint8_t ratio);
+AHT21_Result aht21_get_spread(AHT21_Handle* handle, float* temp_spread, float* humi_spread);
+#endif
+
+#if AHT21_USE_EVENTS
+// Event callbacks - attach after init (compact: the last attached callback
+// serves all attached events)
+void aht21_attach(AHT21_Handle* handle, AHT21_Event event, AHT21_Callback cb);
+void aht21_detach(AHT21_Handle* handle, AHT21_Event event);
+#endif
+
+#if AHT21_RING_SIZE > 0
+// Sample ring - converts to float while draining
+uint16_t aht21_ring_count(AHT21_Handle* handle);
+uint16_t aht21_ring_drain(AHT21_Handle* handle, AHT21_Sample* samples, uint16_t max);
+#endif
 
 // State machine function - call periodically in timer
 void aht21_ticks(AHT21_Handle* handle);
 
+// Duty-cycled operation - sleep aht21_next_wakeup() ticks between calls
+void aht21_ticks_elapsed(AHT21_Handle* handle, uint32_t elapsed);
+uint32_t aht21_next_wakeup(AHT21_Handle* handle);
+
 // Convenience function - blocking read
 AHT21_Result aht21_read_blocking(AHT21_Handle* handle, float* temp, float* humi);
 
+// Shared read - last sample if not older than max_age_ms, otherwise joins
+// the conversion in flight or starts one; every waiter gets the same sample
+// (sample age needs AHT21_USE_TIMESTAMPS and aht21_set_clock())
+AHT21_Result aht21_read_fresh(AHT21_Handle* handle, uint32_t max_age_ms, float* temp, float* humi);
+
+// Batch decoding of raw frames (count * AHT21_FRAME_SIZE bytes, e.g. forwarded
+// from remote nodes), same values as the driver, valid may be NULL
+uint32_t aht21_decode_batch(const uint8_t* frames, uint32_t count,
+                            float* temp, float* humi, uint8_t* valid);
+
+// Group operations - trigger all, then read all
+AHT21_Result aht21_trigger_all(AHT21_Handle* const* handles, uint8_t count);
+AHT21_Result aht21_read_all(AHT21_Handle* const* handles, uint8_t count);
+AHT21_Result aht21_read_all_blocking(AHT21_Handle* const* handles, uint8_t count);
+
 #ifdef __cplusplus
 }
 #endif
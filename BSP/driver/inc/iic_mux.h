@@ -0,0 +1,41 @@
+/*
+ * IIC Multiplexer Layer - TCA9548A-style channel switch
+ * Built on top of IIC abstract layer, caches the selected channel
+ */
+
+#ifndef __IIC_MUX_H__
+#define __IIC_MUX_H__
+
+#include "iic_abstract.h"
+
+// Default multiplexer address (A2..A0 = 0)
+#define IIC_MUX_ADDR            0x70
+
+// Number of downstream channels
+#define IIC_MUX_CHANNELS        8
+
+// No channel selected / selection unknown
+#define IIC_MUX_NONE            0xFF
+
+// IIC multiplexer handle
+typedef struct {
+    IIC_Handle* iic;            // upstream IIC handle
+    uint8_t addr;               // multiplexer address
+    uint8_t channel;            // cached selected channel
+} IIC_Mux;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// API functions
+void iic_mux_init(IIC_Mux* mux, IIC_Handle* iic, uint8_t addr);
+IIC_Result iic_mux_select(IIC_Mux* mux, uint8_t channel);
+IIC_Result iic_mux_disable(IIC_Mux* mux);
+void iic_mux_invalidate(IIC_Mux* mux);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __IIC_MUX_H__
@@ -4,9 +4,95 @@
 
 #include "aht21.h"
 
+// State timer limit (16-bit with AHT21_COMPACT)
+#if AHT21_COMPACT
+#define AHT21_TICKS_MAX             0xFFFFu
+#else
+#define AHT21_TICKS_MAX             0xFFFFFFFFu
+#endif
+
+// Conversions making up one sample
+#if AHT21_USE_OVERSAMPLING
+#define AHT21_CONVERSIONS(handle)   ((handle)->os_ratio)
+#else
+#define AHT21_CONVERSIONS(handle)   1
+#endif
+
+// Frames unpacked per block in aht21_decode_batch()
+#define AHT21_DECODE_BLOCK          32
+
+// CRC8 lookup, polynomial 0x31
+static const uint8_t aht21_crc8_table[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+    0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+    0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+    0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+    0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+    0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+    0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F, 0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+    0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+    0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+    0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+    0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+    0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+    0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC
+};
+
+// Packed 20-bit codes of last sample (frame bytes 1..5)
+#if AHT21_COMPACT
+#define AHT21_RAW_CODES(handle)     ((handle)->raw)
+#else
+#define AHT21_RAW_CODES(handle)     (&(handle)->raw_data[1])
+#endif
+
+#if AHT21_USE_TIMESTAMPS
+// Timestamp clock
+static AHT21_Clock aht21_clock = NULL;
+#endif
+
 // Internal helper functions
+static void aht21_setup(AHT21_Handle* handle, IIC_Handle* iic);
+static void aht21_set_state(AHT21_Handle* handle, AHT21_State state);
+static void aht21_set_error(AHT21_Handle* handle);
+static void aht21_event(AHT21_Handle* handle, AHT21_Event event);
+static uint32_t aht21_backoff_ms(AHT21_Handle* handle);
+static uint32_t aht21_state_wait(AHT21_Handle* handle);
+static void aht21_start_cycle(AHT21_Handle* handle);
+static void aht21_delay_ms(AHT21_Handle* handle, uint32_t ms);
+#if AHT21_USE_TIMESTAMPS
+static uint32_t aht21_now(AHT21_Handle* handle);
+#endif
+static uint8_t aht21_valid_group(AHT21_Handle* const* handles, uint8_t count);
+static AHT21_Result aht21_power_up(AHT21_Handle* handle);
+static IIC_Result aht21_write(AHT21_Handle* handle, const uint8_t* data, uint16_t len);
+static IIC_Result aht21_read(AHT21_Handle* handle, uint8_t* data, uint16_t len);
+static AHT21_Result aht21_send_init(AHT21_Handle* handle);
+static AHT21_Result aht21_send_trigger(AHT21_Handle* handle);
+static AHT21_Result aht21_send_reset(AHT21_Handle* handle);
+static AHT21_Result aht21_check_calibrated(AHT21_Handle* handle);
+static uint8_t aht21_reset_done(AHT21_Handle* handle);
 static AHT21_Result aht21_check_status(AHT21_Handle* handle, uint8_t* status);
+#if !AHT21_COMPACT && !AHT21_LAZY_CONVERT
 static void aht21_parse_data(AHT21_Handle* handle);
+#endif
+static uint8_t aht21_has_sample(AHT21_Handle* handle);
+static void aht21_last_sample(AHT21_Handle* handle, float* temp, float* humi);
+static float aht21_calc_temperature(const uint8_t* raw);
+static float aht21_calc_humidity(const uint8_t* raw);
+static inline float aht21_code_to_temperature(int32_t code);
+static inline float aht21_code_to_humidity(int32_t code);
+static inline uint8_t aht21_crc8(const uint8_t* data, uint8_t len);
+#if AHT21_USE_OVERSAMPLING
+static uint8_t aht21_os_accumulate(AHT21_Handle* handle);
+static void aht21_unpack(const uint8_t* raw, uint32_t* humi, uint32_t* temp);
+static void aht21_pack(uint8_t* raw, uint32_t humi, uint32_t temp);
+#endif
+#if AHT21_RING_SIZE > 0
+static void aht21_ring_push(AHT21_Handle* handle);
+#endif
 
 /**
   * @brief  Initialize AHT21 sensor
@@ -15,38 +101,69 @@ AHT21_Result aht21_init(AHT21_Handle* handle, IIC_Handle* iic)
 {
     if (!handle || !iic) return AHT21_ERR_INVALID_PARAM;
     
-    memset(handle, 0, sizeof(AHT21_Handle));
-    handle->iic = iic;
-    handle->state = AHT21_STATE_INIT;
-    handle->measure_interval = 100;  // default 100ms measurement interval
+    aht21_setup(handle, iic);
+    return aht21_power_up(handle);
+}
+
+/**
+  * @brief  Initialize AHT21 sensor without blocking
+  * @note   Power-up wait, calibration check and init command are
+  *         performed by aht21_ticks(), handle leaves AHT21_STATE_POWER_UP /
+  *         AHT21_STATE_INIT for AHT21_STATE_IDLE or AHT21_STATE_ERROR
+  */
+AHT21_Result aht21_init_async(AHT21_Handle* handle, IIC_Handle* iic)
+{
+    if (!handle || !iic) return AHT21_ERR_INVALID_PARAM;
     
-    // Wait for AHT21 power-up stabilization (recommended 40ms)
-    if (iic->hal_ops->delay_ms) {
-        iic->hal_ops->delay_ms(40);
-    }
+    aht21_setup(handle, iic);
+    aht21_set_state(handle, AHT21_STATE_POWER_UP);
+    return AHT21_OK;
+}
+
+#if AHT21_USE_MUX
+/**
+  * @brief  Initialize AHT21 sensor behind IIC multiplexer channel
+  */
+AHT21_Result aht21_init_mux(AHT21_Handle* handle, IIC_Mux* mux, uint8_t channel)
+{
+    if (!handle || !mux || channel >= IIC_MUX_CHANNELS) return AHT21_ERR_INVALID_PARAM;
     
-    // Send initialization command
-    uint8_t init_cmd[3] = {AHT21_CMD_INIT, 0x08, 0x00};
-    if (iic_write(iic, AHT21_ADDR, init_cmd, 3) != IIC_OK) {
-        handle->state = AHT21_STATE_ERROR;
-        return AHT21_ERR_IIC;
-    }
+    aht21_setup(handle, mux->iic);
+    handle->mux = mux;
+    handle->mux_channel = channel;
+    return aht21_power_up(handle);
+}
+
+/**
+  * @brief  Initialize AHT21 sensor behind IIC multiplexer channel without blocking
+  */
+AHT21_Result aht21_init_mux_async(AHT21_Handle* handle, IIC_Mux* mux, uint8_t channel)
+{
+    if (!handle || !mux || channel >= IIC_MUX_CHANNELS) return AHT21_ERR_INVALID_PARAM;
     
-    // Wait for initialization to complete
-    if (iic->hal_ops->delay_ms) {
-        iic->hal_ops->delay_ms(10);
-    }
+    aht21_setup(handle, mux->iic);
+    handle->mux = mux;
+    handle->mux_channel = channel;
+    aht21_set_state(handle, AHT21_STATE_POWER_UP);
+    return AHT21_OK;
+}
+#endif
+
+/**
+  * @brief  Soft reset AHT21
+  */
+AHT21_Result aht21_soft_reset(AHT21_Handle* handle)
+{
+    if (!handle) return AHT21_ERR_INVALID_PARAM;
     
-    // Check calibration status
-    uint8_t status;
-    if (aht21_check_status(handle, &status) != AHT21_OK) {
-        handle->state = AHT21_STATE_ERROR;
+    if (aht21_send_reset(handle) != AHT21_OK) {
         return AHT21_ERR_IIC;
     }
     
-    if (!(status & AHT21_STATUS_CALIBRATED)) {
-        handle->state = AHT21_STATE_ERROR;
-        return AHT21_ERR_NOT_INIT;
+    // Poll until the device reports calibrated again, 20ms upper bound
+    for (uint32_t waited = 0; waited < AHT21_RESET_TIME; waited += AHT21_RESET_POLL) {
+        aht21_delay_ms(handle, AHT21_RESET_POLL);
+        if (aht21_reset_done(handle)) break;
     }
     
     handle->state = AHT21_STATE_IDLE;
@@ -54,23 +171,19 @@ AHT21_Result aht21_init(AHT21_Handle* handle, IIC_Handle* iic)
 }
 
 /**
-  * @brief  Soft reset AHT21
+  * @brief  Soft reset AHT21 without blocking
+  * @note   aht21_ticks() polls status in AHT21_STATE_RESET until the device
+  *         reports calibrated, at most AHT21_RESET_TIME
   */
-AHT21_Result aht21_soft_reset(AHT21_Handle* handle)
+AHT21_Result aht21_soft_reset_async(AHT21_Handle* handle)
 {
     if (!handle) return AHT21_ERR_INVALID_PARAM;
     
-    uint8_t reset_cmd = AHT21_CMD_SOFT_RESET;
-    if (iic_write(handle->iic, AHT21_ADDR, &reset_cmd, 1) != IIC_OK) {
+    if (aht21_send_reset(handle) != AHT21_OK) {
         return AHT21_ERR_IIC;
     }
     
-    // Wait for reset to complete
-    if (handle->iic->hal_ops->delay_ms) {
-        handle->iic->hal_ops->delay_ms(20);
-    }
-    
-    handle->state = AHT21_STATE_IDLE;
+    aht21_set_state(handle, AHT21_STATE_RESET);
     return AHT21_OK;
 }
 
@@ -80,16 +193,30 @@ AHT21_Result aht21_soft_reset(AHT21_Handle* handle)
 AHT21_Result aht21_trigger_measure(AHT21_Handle* handle)
 {
     if (!handle) return AHT21_ERR_INVALID_PARAM;
-    if (handle->state == AHT21_STATE_WAIT_MEASURE) return AHT21_ERR_BUSY;
+    if (handle->state == AHT21_STATE_WAIT_MEASURE ||
+        handle->state == AHT21_STATE_POWER_UP ||
+        handle->state == AHT21_STATE_INIT ||
+        handle->state == AHT21_STATE_RESET) return AHT21_ERR_BUSY;
     
-    // Send measurement command
-    uint8_t measure_cmd[3] = {AHT21_CMD_TRIGGER, 0x33, 0x00};
-    if (iic_write(handle->iic, AHT21_ADDR, measure_cmd, 3) != IIC_OK) {
+    // Send measurement command, bus failure enters recovery (back-off)
+    if (aht21_send_trigger(handle) != AHT21_OK) {
+        aht21_set_error(handle);
         return AHT21_ERR_IIC;
     }
     
-    handle->state = AHT21_STATE_WAIT_MEASURE;
-    handle->measure_ticks = 0;
+    // Back from error recovery
+    if (handle->in_error) {
+        handle->in_error = 0;
+        aht21_event(handle, AHT21_EVENT_RECOVERED);
+    }
+    
+    aht21_set_state(handle, AHT21_STATE_WAIT_MEASURE);
+#if AHT21_USE_TIMESTAMPS
+    handle->trigger_time = aht21_now(handle);
+#endif
+#if AHT21_USE_OVERSAMPLING
+    handle->os_count = 0;
+#endif
     
     return AHT21_OK;
 }
@@ -101,9 +228,14 @@ AHT21_Result aht21_read_data(AHT21_Handle* handle)
 {
     if (!handle) return AHT21_ERR_INVALID_PARAM;
     
-    // Check status
+#if AHT21_USE_OVERSAMPLING
+    handle->os_restarted = 0;
+#endif
+    
+    // Check status, bus failures enter recovery (back-off)
     uint8_t status;
     if (aht21_check_status(handle, &status) != AHT21_OK) {
+        aht21_set_error(handle);
         return AHT21_ERR_IIC;
     }
     
@@ -112,26 +244,84 @@ AHT21_Result aht21_read_data(AHT21_Handle* handle)
     }
     
     // Read 7 bytes of data
-    if (iic_read(handle->iic, AHT21_ADDR, handle->raw_data, 7) != IIC_OK) {
+#if AHT21_COMPACT
+    // Keep only the packed codes, converted on demand
+    uint8_t raw_data[7];
+    if (aht21_read(handle, raw_data, 7) != IIC_OK) {
+        aht21_set_error(handle);
         return AHT21_ERR_IIC;
     }
+    memcpy(handle->raw, &raw_data[1], sizeof(handle->raw));
+#else
+    if (aht21_read(handle, handle->raw_data, 7) != IIC_OK) {
+        aht21_set_error(handle);
+        return AHT21_ERR_IIC;
+    }
+    
+#endif
+    
+#if AHT21_USE_OVERSAMPLING
+    // Accumulate, start next back-to-back conversion until ratio is reached
+    if (!aht21_os_accumulate(handle)) {
+        if (aht21_send_trigger(handle) != AHT21_OK) {
+            aht21_set_error(handle);
+            return AHT21_ERR_IIC;
+        }
+        aht21_set_state(handle, AHT21_STATE_WAIT_MEASURE);
+        handle->os_restarted = 1;
+        return AHT21_ERR_BUSY;
+    }
+#endif
     
+#if !AHT21_COMPACT && !AHT21_LAZY_CONVERT
     // Parse data
     aht21_parse_data(handle);
-    handle->state = AHT21_STATE_READY;
+#endif
+#if AHT21_USE_TIMESTAMPS
+    handle->sample_time = aht21_now(handle);
+#endif
+    if (++handle->sample_seq == 0) handle->sample_seq = 1;
+    aht21_set_state(handle, AHT21_STATE_READY);
+    handle->retry_count = 0;
+    
+    // Single completion point, every caller path queues and notifies
+#if AHT21_RING_SIZE > 0
+    aht21_ring_push(handle);
+#endif
+    aht21_event(handle, AHT21_EVENT_DATA_READY);
     
     return AHT21_OK;
 }
 
+/**
+  * @brief  Time until the conversion in flight can be read (ms)
+  * @note   After aht21_read_data() returned AHT21_ERR_BUSY: a whole
+  *         conversion if it accumulated one and started the next
+  *         (oversampling), 0 if the sensor was still converting
+  */
+uint32_t aht21_read_wait(AHT21_Handle* handle)
+{
+#if AHT21_USE_OVERSAMPLING
+    if (handle && handle->os_restarted) return AHT21_MEASURE_TIME;
+#else
+    (void)handle;
+#endif
+    return 0;
+}
+
 /**
   * @brief  Get temperature
   */
 AHT21_Result aht21_get_temperature(AHT21_Handle* handle, float* temp)
 {
     if (!handle || !temp) return AHT21_ERR_INVALID_PARAM;
-    if (handle->state != AHT21_STATE_READY) return AHT21_ERR_NOT_INIT;
+    if (!aht21_has_sample(handle)) return AHT21_ERR_NOT_INIT;
     
+#if AHT21_COMPACT || AHT21_LAZY_CONVERT
+    *temp = aht21_calc_temperature(AHT21_RAW_CODES(handle));
+#else
     *temp = handle->temperature;
+#endif
     return AHT21_OK;
 }
 
@@ -141,47 +331,265 @@ AHT21_Result aht21_get_temperature(AHT21_Handle* handle, float* temp)
 AHT21_Result aht21_get_humidity(AHT21_Handle* handle, float* humi)
 {
     if (!handle || !humi) return AHT21_ERR_INVALID_PARAM;
-    if (handle->state != AHT21_STATE_READY) return AHT21_ERR_NOT_INIT;
+    if (!aht21_has_sample(handle)) return AHT21_ERR_NOT_INIT;
     
+#if AHT21_COMPACT || AHT21_LAZY_CONVERT
+    *humi = aht21_calc_humidity(AHT21_RAW_CODES(handle));
+#else
     *humi = handle->humidity;
+#endif
     return AHT21_OK;
 }
 
+#if AHT21_USE_OVERSAMPLING
+/**
+  * @brief  Set number of conversions averaged per sample
+  */
+AHT21_Result aht21_set_oversampling(AHT21_Handle* handle, uint8_t ratio)
+{
+    if (!handle || ratio == 0 || ratio > AHT21_OVERSAMPLE_MAX) return AHT21_ERR_INVALID_PARAM;
+    
+    handle->os_ratio = ratio;
+    handle->os_count = 0;
+    return AHT21_OK;
+}
+
+/**
+  * @brief  Get spread (max - min) of conversions in last sample
+  */
+AHT21_Result aht21_get_spread(AHT21_Handle* handle, float* temp_spread, float* humi_spread)
+{
+    if (!handle || !temp_spread || !humi_spread) return AHT21_ERR_INVALID_PARAM;
+    if (!aht21_has_sample(handle)) return AHT21_ERR_NOT_INIT;
+    
+    *temp_spread = (handle->temp_spread * 200.0f) / 1048576.0f;
+    *humi_spread = (handle->humi_spread * 100.0f) / 1048576.0f;
+    return AHT21_OK;
+}
+#endif
+
+/**
+  * @brief  Get trigger and completion time of last sample (ms)
+  * @retval AHT21_ERR_NOT_INIT without a sample or without AHT21_USE_TIMESTAMPS,
+  *         compact layout also without aht21_set_clock() (no time base to report)
+  */
+AHT21_Result aht21_get_timestamps(AHT21_Handle* handle, uint32_t* trigger, uint32_t* complete)
+{
+    if (!handle || !trigger || !complete) return AHT21_ERR_INVALID_PARAM;
+    if (!aht21_has_sample(handle)) return AHT21_ERR_NOT_INIT;
+#if AHT21_USE_TIMESTAMPS
+#if AHT21_COMPACT
+    if (!aht21_clock) return AHT21_ERR_NOT_INIT;
+#endif
+    
+    *trigger = handle->trigger_time;
+    *complete = handle->sample_time;
+    return AHT21_OK;
+#else
+    return AHT21_ERR_NOT_INIT;
+#endif
+}
+
+#if AHT21_USE_TIMESTAMPS
+/**
+  * @brief  Set timestamp clock
+  * @note   Without a clock timestamps count aht21_ticks() periods,
+  *         which don't advance during blocking reads (0 with AHT21_COMPACT)
+  */
+void aht21_set_clock(AHT21_Clock clock)
+{
+    aht21_clock = clock;
+}
+#endif
+
+#if AHT21_USE_EVENTS
+/**
+  * @brief  Attach event callback
+  */
+void aht21_attach(AHT21_Handle* handle, AHT21_Event event, AHT21_Callback cb)
+{
+    if (!handle || event >= AHT21_EVENT_NUM) return;
+#if AHT21_COMPACT
+    handle->cb = cb;
+    handle->cb_events |= (uint8_t)(1u << event);
+#else
+    handle->cb[event] = cb;
+#endif
+}
+
+/**
+  * @brief  Detach event callback
+  */
+void aht21_detach(AHT21_Handle* handle, AHT21_Event event)
+{
+    if (!handle || event >= AHT21_EVENT_NUM) return;
+#if AHT21_COMPACT
+    handle->cb_events &= (uint8_t)~(1u << event);
+#else
+    handle->cb[event] = NULL;
+#endif
+}
+#endif
+
+#if AHT21_RING_SIZE > 0
+/**
+  * @brief  Number of samples waiting in ring
+  */
+uint16_t aht21_ring_count(AHT21_Handle* handle)
+{
+    if (!handle) return 0;
+    
+    uint8_t head = handle->ring_head;
+    uint8_t tail = handle->ring_tail;
+    return (head >= tail) ? (head - tail) : (AHT21_RING_SIZE - tail + head);
+}
+
+/**
+  * @brief  Drain up to max samples from ring, oldest first
+  * @note   Single consumer, may run concurrently with aht21_ticks()
+  * @retval number of samples written
+  */
+uint16_t aht21_ring_drain(AHT21_Handle* handle, AHT21_Sample* samples, uint16_t max)
+{
+    if (!handle || !samples) return 0;
+    
+    uint8_t head = handle->ring_head;
+    uint8_t tail = handle->ring_tail;
+    uint16_t count = 0;
+    
+    AHT21_BARRIER();
+    while (tail != head && count < max) {
+        const AHT21_RawSample* raw = &handle->ring[tail];
+#if AHT21_USE_TIMESTAMPS
+        samples[count].timestamp = raw->timestamp;
+#endif
+        samples[count].temperature = aht21_calc_temperature(raw->raw);
+        samples[count].humidity = aht21_calc_humidity(raw->raw);
+        count++;
+        tail = (tail + 1 < AHT21_RING_SIZE) ? (tail + 1) : 0;
+    }
+    AHT21_BARRIER();
+    
+    handle->ring_tail = tail;
+    return count;
+}
+#endif
+
 /**
   * @brief  State machine - call periodically in timer (recommended 5-10ms)
   */
 void aht21_ticks(AHT21_Handle* handle)
+{
+    aht21_ticks_elapsed(handle, 1);
+}
+
+/**
+  * @brief  State machine - advance by several ticks at once
+  * @note   For duty-cycled operation: sleep for aht21_next_wakeup() ticks,
+  *         then call with the number of ticks actually slept
+  */
+void aht21_ticks_elapsed(AHT21_Handle* handle, uint32_t elapsed)
 {
     if (!handle) return;
     
+#if AHT21_USE_TIMESTAMPS && !AHT21_COMPACT
+    handle->uptime_ticks += elapsed;
+#endif
+    
+    // Saturate so the state timer can't wrap after a long sleep
+    if (elapsed < AHT21_TICKS_MAX - handle->measure_ticks) {
+        handle->measure_ticks += elapsed;
+    } else {
+        handle->measure_ticks = AHT21_TICKS_MAX;
+    }
+    uint8_t due = (handle->measure_ticks >= aht21_state_wait(handle));
+    
     switch (handle->state) {
+    case AHT21_STATE_POWER_UP:
+        // Wait for power-up stabilization, then check calibration
+        if (due) {
+            AHT21_Result result = aht21_check_calibrated(handle);
+            if (result == AHT21_OK) {
+                // Already calibrated - skip initialization command
+                aht21_set_state(handle, AHT21_STATE_IDLE);
+            } else if (result == AHT21_ERR_NOT_INIT && aht21_send_init(handle) == AHT21_OK) {
+                aht21_set_state(handle, AHT21_STATE_INIT);
+            } else {
+                aht21_set_error(handle);
+            }
+        }
+        break;
+        
+    case AHT21_STATE_INIT:
+        // Wait for calibration, then check status
+        if (due) {
+            if (aht21_check_calibrated(handle) == AHT21_OK) {
+                aht21_set_state(handle, AHT21_STATE_IDLE);
+            } else {
+                aht21_set_error(handle);
+            }
+        }
+        break;
+        
+    case AHT21_STATE_RESET:
+        // Poll for soft reset completion, 20ms upper bound
+        if (due) {
+            if (aht21_reset_done(handle) ||
+                handle->measure_ticks >= AHT21_MS_TO_TICKS(AHT21_RESET_TIME)) {
+                aht21_set_state(handle, AHT21_STATE_IDLE);
+            }
+        }
+        break;
+        
     case AHT21_STATE_IDLE:
-        // Automatically trigger measurement
-        aht21_trigger_measure(handle);
+        aht21_start_cycle(handle);
         break;
         
     case AHT21_STATE_WAIT_MEASURE:
-        handle->measure_ticks++;
         // AHT21 measurement time is about 80ms
-        if (handle->measure_ticks >= 80 / 5) {  // assuming 5ms call interval
-            if (aht21_read_data(handle) == AHT21_OK) {
-                handle->state = AHT21_STATE_READY;
-            }
+        if (due) {
+            aht21_read_data(handle);
         }
         break;
         
     case AHT21_STATE_READY:
-        // Wait for a period before measuring again
-        handle->measure_ticks++;
-        if (handle->measure_ticks >= handle->measure_interval / 5) {
-            handle->state = AHT21_STATE_IDLE;
-            handle->measure_ticks = 0;
+        // Wait for a period before measuring again, trigger in the same
+        // wakeup so duty-cycled callers don't need an extra one
+        if (due) {
+            aht21_set_state(handle, AHT21_STATE_IDLE);
+            aht21_start_cycle(handle);
         }
         break;
         
     case AHT21_STATE_ERROR:
-        // Error state - try soft reset
-        aht21_soft_reset(handle);
+        // Error entered outside the state machine (e.g. aht21_init failed)
+        if (!handle->in_error) {
+            handle->in_error = 1;
+            aht21_event(handle, AHT21_EVENT_ERROR);
+        }
+        
+        // Retry budget exhausted - stop using bus time
+        if (handle->retry_count >= AHT21_RETRY_MAX) {
+            aht21_set_state(handle, AHT21_STATE_OFFLINE);
+            break;
+        }
+        
+        // Soft reset after exponential back-off, completed in AHT21_STATE_RESET
+        if (due) {
+            handle->retry_count++;
+            if (aht21_soft_reset_async(handle) != AHT21_OK) {
+                handle->measure_ticks = 0;
+            }
+        }
+        break;
+        
+    case AHT21_STATE_OFFLINE:
+        // Probe with soft reset, back to AHT21_STATE_RESET once it is acknowledged
+        if (due) {
+            if (aht21_soft_reset_async(handle) != AHT21_OK) {
+                handle->measure_ticks = 0;
+            }
+        }
         break;
         
     default:
@@ -190,6 +598,19 @@ void aht21_ticks(AHT21_Handle* handle)
     }
 }
 
+/**
+  * @brief  Ticks until the state machine has bus work to do
+  * @note   The MCU can sleep this long between aht21_ticks_elapsed() calls,
+  *         minimum 1 (e.g. sensor still busy after conversion time)
+  */
+uint32_t aht21_next_wakeup(AHT21_Handle* handle)
+{
+    if (!handle) return 1;
+    
+    uint32_t wait = aht21_state_wait(handle);
+    return (wait > handle->measure_ticks) ? (wait - handle->measure_ticks) : 1;
+}
+
 /**
   * @brief  Blocking read temperature and humidity
   */
@@ -203,52 +624,650 @@ AHT21_Result aht21_read_blocking(AHT21_Handle* handle, float* temp, float* humi)
     result = aht21_trigger_measure(handle);
     if (result != AHT21_OK) return result;
     
-    // Wait for measurement to complete (80ms)
-    if (handle->iic->hal_ops->delay_ms) {
-        handle->iic->hal_ops->delay_ms(80);
+    // Wait for each conversion (80ms) and read it, a sensor still busy is
+    // polled again for up to one more conversion time
+    uint32_t late = 0;
+    aht21_delay_ms(handle, AHT21_MEASURE_TIME);
+    while ((result = aht21_read_data(handle)) == AHT21_ERR_BUSY) {
+        if (aht21_read_wait(handle)) {
+            // Conversion accepted, next one started (oversampling)
+            aht21_delay_ms(handle, AHT21_MEASURE_TIME);
+            late = 0;
+        } else {
+            if (late >= AHT21_MEASURE_TIME) break;
+            aht21_delay_ms(handle, AHT21_FRESH_POLL);
+            late += AHT21_FRESH_POLL;
+        }
     }
-    
-    // Read data
-    result = aht21_read_data(handle);
     if (result != AHT21_OK) return result;
     
-    *temp = handle->temperature;
-    *humi = handle->humidity;
+    aht21_get_temperature(handle, temp);
+    aht21_get_humidity(handle, humi);
     
     return AHT21_OK;
 }
 
+/**
+  * @brief  Read sample no older than max_age_ms
+  * @note   Age needs aht21_set_clock(), without a clock the last sample
+  *         counts as expired (tick uptime doesn't advance for blocking or
+  *         sensor layer callers). Callers that find a conversion in flight
+  *         wait for the sample sequence to advance instead of triggering
+  *         again, so concurrent readers of the same sensor share one conversion
+  */
+AHT21_Result aht21_read_fresh(AHT21_Handle* handle, uint32_t max_age_ms, float* temp, float* humi)
+{
+    if (!handle || !temp || !humi) return AHT21_ERR_INVALID_PARAM;
+    
+    uint8_t seq = handle->sample_seq;
+    
+#if AHT21_USE_TIMESTAMPS
+    // Last sample still young enough
+    if (aht21_has_sample(handle) && aht21_clock &&
+        (uint32_t)(aht21_now(handle) - handle->sample_time) <= max_age_ms) {
+        aht21_last_sample(handle, temp, humi);
+        return AHT21_OK;
+    }
+#else
+    (void)max_age_ms;
+#endif
+    
+    // Start a conversion unless one is already in flight
+    uint32_t waited = 0;
+    if (handle->state != AHT21_STATE_WAIT_MEASURE) {
+        AHT21_Result result = aht21_trigger_measure(handle);
+        if (result == AHT21_ERR_IIC) return result;
+        if (result == AHT21_OK) {
+            aht21_delay_ms(handle, AHT21_MEASURE_TIME);
+            waited = AHT21_MEASURE_TIME;
+        }
+    }
+    
+    // Wait for the next completed sample, whoever reads it
+    uint32_t timeout = 2u * AHT21_CONVERSIONS(handle) * AHT21_MEASURE_TIME + AHT21_RESET_TIME;
+    while (handle->sample_seq == seq) {
+        if (handle->state == AHT21_STATE_WAIT_MEASURE) {
+            // Give a tick-driven reader the first chance at the frame
+            if (waited >= AHT21_MEASURE_TIME &&
+                aht21_read_data(handle) == AHT21_ERR_IIC) {
+                return AHT21_ERR_IIC;
+            }
+            if (handle->sample_seq != seq) break;
+        } else if (handle->state == AHT21_STATE_ERROR || handle->state == AHT21_STATE_OFFLINE) {
+            return AHT21_ERR_IIC;
+        } else if (handle->state == AHT21_STATE_IDLE || handle->state == AHT21_STATE_READY) {
+            // Power-up/reset finished meanwhile
+            AHT21_Result result = aht21_trigger_measure(handle);
+            if (result != AHT21_OK) return result;
+        }
+        
+        if (waited >= timeout) return AHT21_ERR_TIMEOUT;
+        aht21_delay_ms(handle, AHT21_FRESH_POLL);
+        waited += AHT21_FRESH_POLL;
+    }
+    
+    aht21_last_sample(handle, temp, humi);
+    return AHT21_OK;
+}
+
+/**
+  * @brief  Trigger measurement on a group of sensors
+  * @note   Conversions run in parallel, e.g. on all multiplexer channels
+  * @retval AHT21_OK if every trigger succeeded, otherwise last error
+  */
+AHT21_Result aht21_trigger_all(AHT21_Handle* const* handles, uint8_t count)
+{
+    if (!aht21_valid_group(handles, count)) return AHT21_ERR_INVALID_PARAM;
+    
+    AHT21_Result result = AHT21_OK;
+    for (uint8_t i = 0; i < count; i++) {
+        AHT21_Result r = aht21_trigger_measure(handles[i]);
+        if (r != AHT21_OK) result = r;
+    }
+    return result;
+}
+
+/**
+  * @brief  Read data from a group of triggered sensors
+  * @retval AHT21_OK if every read succeeded, otherwise last error
+  */
+AHT21_Result aht21_read_all(AHT21_Handle* const* handles, uint8_t count)
+{
+    if (!aht21_valid_group(handles, count)) return AHT21_ERR_INVALID_PARAM;
+    
+    AHT21_Result result = AHT21_OK;
+    for (uint8_t i = 0; i < count; i++) {
+        AHT21_Result r = aht21_read_data(handles[i]);
+        if (r != AHT21_OK) result = r;
+    }
+    return result;
+}
+
+/**
+  * @brief  Blocking read of a group of sensors with one shared conversion wait
+  * @note   Results are fetched per handle with aht21_get_temperature/humidity
+  */
+AHT21_Result aht21_read_all_blocking(AHT21_Handle* const* handles, uint8_t count)
+{
+    if (count == 0 || !aht21_valid_group(handles, count)) return AHT21_ERR_INVALID_PARAM;
+    
+    AHT21_Result result = aht21_trigger_all(handles, count);
+    
+    // Wait once for all conversions (80ms), read those still measuring; a
+    // group with sensors still busy only is polled for one more conversion
+    uint8_t pending;
+    uint8_t restarted = 1;
+    uint32_t late = 0;
+    do {
+        aht21_delay_ms(handles[0], restarted ? AHT21_MEASURE_TIME : AHT21_FRESH_POLL);
+        late = restarted ? 0 : late + AHT21_FRESH_POLL;
+        
+        pending = 0;
+        restarted = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (handles[i]->state != AHT21_STATE_WAIT_MEASURE) continue;
+            
+            AHT21_Result r = aht21_read_data(handles[i]);
+            if (r == AHT21_ERR_BUSY) {
+                pending++;
+                if (aht21_read_wait(handles[i])) restarted = 1;
+            } else if (r != AHT21_OK) {
+                result = r;
+            }
+        }
+    } while (pending && (restarted || late < AHT21_MEASURE_TIME));
+    
+    return pending ? AHT21_ERR_BUSY : result;
+}
+
+/**
+  * @brief  Decode a batch of raw frames into temperature/humidity arrays
+  * @note   Frames are unpacked block-wise into code arrays so the
+  *         conversion loops are plain SoA loops the compiler can vectorize.
+  *         A frame is valid when its CRC matches and the busy bit is clear.
+  * @retval number of valid frames
+  */
+uint32_t aht21_decode_batch(const uint8_t* frames, uint32_t count,
+                            float* restrict temp, float* restrict humi, uint8_t* valid)
+{
+    if (!frames || !temp || !humi) return 0;
+    
+    int32_t humi_code[AHT21_DECODE_BLOCK];
+    int32_t temp_code[AHT21_DECODE_BLOCK];
+    uint32_t valid_count = 0;
+    
+    for (uint32_t base = 0; base < count; base += AHT21_DECODE_BLOCK) {
+        uint32_t n = (count - base < AHT21_DECODE_BLOCK) ? (count - base) : AHT21_DECODE_BLOCK;
+        const uint8_t* frame = frames + base * AHT21_FRAME_SIZE;
+        
+        // Unpack 20-bit codes and check frames
+        for (uint32_t i = 0; i < n; i++, frame += AHT21_FRAME_SIZE) {
+            humi_code[i] = ((int32_t)frame[1] << 12) |
+                           ((int32_t)frame[2] << 4) |
+                           ((int32_t)frame[3] >> 4);
+            temp_code[i] = (((int32_t)frame[3] & 0x0F) << 16) |
+                           ((int32_t)frame[4] << 8) |
+                           ((int32_t)frame[5]);
+            
+            uint8_t ok = (aht21_crc8(frame, AHT21_FRAME_SIZE - 1) == frame[6]) &&
+                         !(frame[0] & AHT21_STATUS_BUSY);
+            valid_count += ok;
+            if (valid) valid[base + i] = ok;
+        }
+        
+        // Convert, same expressions as the scalar path
+        float* restrict temp_out = temp + base;
+        float* restrict humi_out = humi + base;
+        for (uint32_t i = 0; i < n; i++) {
+            temp_out[i] = aht21_code_to_temperature(temp_code[i]);
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            humi_out[i] = aht21_code_to_humidity(humi_code[i]);
+        }
+    }
+    
+    return valid_count;
+}
+
 // ========== Internal Functions ==========
 
+/**
+  * @brief  Reset handle fields to defaults
+  */
+static void aht21_setup(AHT21_Handle* handle, IIC_Handle* iic)
+{
+    memset(handle, 0, sizeof(AHT21_Handle));
+    handle->iic = iic;
+    handle->measure_interval = 100;  // default 100ms measurement interval
+#if AHT21_USE_OVERSAMPLING
+    handle->os_ratio = 1;
+#endif
+}
+
+/**
+  * @brief  Check a handle group before any of it touches the bus
+  */
+static uint8_t aht21_valid_group(AHT21_Handle* const* handles, uint8_t count)
+{
+    if (!handles) return 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!handles[i]) return 0;
+    }
+    return 1;
+}
+
+/**
+  * @brief  Enter state and restart state timer
+  */
+static void aht21_set_state(AHT21_Handle* handle, AHT21_State state)
+{
+    handle->state = state;
+    handle->measure_ticks = 0;
+}
+
+/**
+  * @brief  Enter error state, notify once per error episode
+  */
+static void aht21_set_error(AHT21_Handle* handle)
+{
+    aht21_set_state(handle, AHT21_STATE_ERROR);
+    if (!handle->in_error) {
+        handle->in_error = 1;
+        aht21_event(handle, AHT21_EVENT_ERROR);
+    }
+}
+
+/**
+  * @brief  Fire event callback
+  */
+static void aht21_event(AHT21_Handle* handle, AHT21_Event event)
+{
+#if !AHT21_USE_EVENTS
+    (void)handle;
+    (void)event;
+#elif AHT21_COMPACT
+    if (handle->cb && (handle->cb_events & (1u << event))) {
+        handle->cb(handle, event);
+    }
+#else
+    if (handle->cb[event]) {
+        handle->cb[event](handle, event);
+    }
+#endif
+}
+
+/**
+  * @brief  Reset back-off for current retry count
+  */
+static uint32_t aht21_backoff_ms(AHT21_Handle* handle)
+{
+    uint32_t backoff = AHT21_BACKOFF_MIN;
+    for (uint8_t i = 0; i < handle->retry_count && backoff < AHT21_BACKOFF_MAX; i++) {
+        backoff <<= 1;
+    }
+    return (backoff < AHT21_BACKOFF_MAX) ? backoff : AHT21_BACKOFF_MAX;
+}
+
+/**
+  * @brief  Ticks to spend in current state before acting
+  */
+static uint32_t aht21_state_wait(AHT21_Handle* handle)
+{
+    switch (handle->state) {
+    case AHT21_STATE_POWER_UP:      return AHT21_MS_TO_TICKS(AHT21_POWER_UP_TIME);
+    case AHT21_STATE_INIT:          return AHT21_MS_TO_TICKS(AHT21_INIT_TIME);
+    case AHT21_STATE_RESET:         return AHT21_MS_TO_TICKS(AHT21_RESET_POLL);
+    case AHT21_STATE_WAIT_MEASURE:  return AHT21_MS_TO_TICKS(AHT21_MEASURE_TIME);
+    case AHT21_STATE_READY:         return AHT21_MS_TO_TICKS(handle->measure_interval);
+    case AHT21_STATE_ERROR:         return AHT21_MS_TO_TICKS(aht21_backoff_ms(handle));
+    case AHT21_STATE_OFFLINE:       return AHT21_MS_TO_TICKS(AHT21_PROBE_INTERVAL);
+    default:                        return 0;
+    }
+}
+
+/**
+  * @brief  Idle - report recovery and trigger next measurement
+  */
+static void aht21_start_cycle(AHT21_Handle* handle)
+{
+    // Automatically trigger measurement, bus failure enters recovery
+    aht21_trigger_measure(handle);
+}
+
+/**
+  * @brief  Blocking power-up sequence
+  */
+static AHT21_Result aht21_power_up(AHT21_Handle* handle)
+{
+    handle->state = AHT21_STATE_INIT;
+    
+    // Wait for AHT21 power-up stabilization (recommended 40ms)
+    aht21_delay_ms(handle, AHT21_POWER_UP_TIME);
+    
+    // Already calibrated (warm restart) - skip initialization command
+    AHT21_Result result = aht21_check_calibrated(handle);
+    if (result == AHT21_ERR_NOT_INIT) {
+        // Send initialization command
+        if (aht21_send_init(handle) != AHT21_OK) {
+            handle->state = AHT21_STATE_ERROR;
+            return AHT21_ERR_IIC;
+        }
+        
+        // Wait for initialization to complete
+        aht21_delay_ms(handle, AHT21_INIT_TIME);
+        
+        // Check calibration status
+        result = aht21_check_calibrated(handle);
+    }
+    handle->state = (result == AHT21_OK) ? AHT21_STATE_IDLE : AHT21_STATE_ERROR;
+    return result;
+}
+
+#if AHT21_USE_TIMESTAMPS
+/**
+  * @brief  Current time (ms) for timestamps
+  */
+static uint32_t aht21_now(AHT21_Handle* handle)
+{
+#if AHT21_COMPACT
+    (void)handle;
+    return aht21_clock ? aht21_clock() : 0;
+#else
+    return aht21_clock ? aht21_clock() : handle->uptime_ticks * AHT21_TICK_INTERVAL;
+#endif
+}
+#endif
+
+/**
+  * @brief  Blocking delay through IIC hardware layer
+  */
+static void aht21_delay_ms(AHT21_Handle* handle, uint32_t ms)
+{
+    if (handle->iic->hal_ops->delay_ms) {
+        handle->iic->hal_ops->delay_ms(ms);
+    }
+}
+
+/**
+  * @brief  Write to AHT21, selecting multiplexer channel first
+  */
+static IIC_Result aht21_write(AHT21_Handle* handle, const uint8_t* data, uint16_t len)
+{
+#if AHT21_USE_MUX
+    if (handle->mux) {
+        IIC_Result result = iic_mux_select(handle->mux, handle->mux_channel);
+        if (result != IIC_OK) return result;
+    }
+#endif
+    return iic_write(handle->iic, AHT21_ADDR, data, len);
+}
+
+/**
+  * @brief  Read from AHT21, selecting multiplexer channel first
+  */
+static IIC_Result aht21_read(AHT21_Handle* handle, uint8_t* data, uint16_t len)
+{
+#if AHT21_USE_MUX
+    if (handle->mux) {
+        IIC_Result result = iic_mux_select(handle->mux, handle->mux_channel);
+        if (result != IIC_OK) return result;
+    }
+#endif
+    return iic_read(handle->iic, AHT21_ADDR, data, len);
+}
+
+/**
+  * @brief  Send initialization (calibration) command
+  */
+static AHT21_Result aht21_send_init(AHT21_Handle* handle)
+{
+    uint8_t init_cmd[3] = {AHT21_CMD_INIT, 0x08, 0x00};
+    if (aht21_write(handle, init_cmd, 3) != IIC_OK) {
+        return AHT21_ERR_IIC;
+    }
+    return AHT21_OK;
+}
+
+/**
+  * @brief  Send measurement command
+  */
+static AHT21_Result aht21_send_trigger(AHT21_Handle* handle)
+{
+    uint8_t measure_cmd[3] = {AHT21_CMD_TRIGGER, 0x33, 0x00};
+    if (aht21_write(handle, measure_cmd, 3) != IIC_OK) {
+        return AHT21_ERR_IIC;
+    }
+    return AHT21_OK;
+}
+
+/**
+  * @brief  Send soft reset command
+  */
+static AHT21_Result aht21_send_reset(AHT21_Handle* handle)
+{
+    uint8_t reset_cmd = AHT21_CMD_SOFT_RESET;
+    if (aht21_write(handle, &reset_cmd, 1) != IIC_OK) {
+        return AHT21_ERR_IIC;
+    }
+    return AHT21_OK;
+}
+
+/**
+  * @brief  Check calibration bit in status
+  */
+static AHT21_Result aht21_check_calibrated(AHT21_Handle* handle)
+{
+    uint8_t status;
+    if (aht21_check_status(handle, &status) != AHT21_OK) {
+        return AHT21_ERR_IIC;
+    }
+    
+    if (!(status & AHT21_STATUS_CALIBRATED)) {
+        return AHT21_ERR_NOT_INIT;
+    }
+    return AHT21_OK;
+}
+
+/**
+  * @brief  Soft reset finished - device answers calibrated and not busy
+  */
+static uint8_t aht21_reset_done(AHT21_Handle* handle)
+{
+    uint8_t status;
+    if (aht21_check_status(handle, &status) != AHT21_OK) return 0;
+    return (status & AHT21_STATUS_CALIBRATED) && !(status & AHT21_STATUS_BUSY);
+}
+
+/**
+  * @brief  Last completed sample can be read (also while the next is measured)
+  */
+static uint8_t aht21_has_sample(AHT21_Handle* handle)
+{
+    if (handle->sample_seq == 0) return 0;
+#if (AHT21_COMPACT || AHT21_LAZY_CONVERT) && AHT21_USE_OVERSAMPLING
+    // Raw codes hold an intermediate conversion while oversampling
+    if (handle->os_count != 0) return 0;
+#endif
+    return 1;
+}
+
+/**
+  * @brief  Values of last completed sample, regardless of state
+  */
+static void aht21_last_sample(AHT21_Handle* handle, float* temp, float* humi)
+{
+#if AHT21_COMPACT || AHT21_LAZY_CONVERT
+    *temp = aht21_calc_temperature(AHT21_RAW_CODES(handle));
+    *humi = aht21_calc_humidity(AHT21_RAW_CODES(handle));
+#else
+    *temp = handle->temperature;
+    *humi = handle->humidity;
+#endif
+}
+
 /**
   * @brief  Check AHT21 status
   */
 static AHT21_Result aht21_check_status(AHT21_Handle* handle, uint8_t* status)
 {
-    if (iic_read(handle->iic, AHT21_ADDR, status, 1) != IIC_OK) {
+    if (aht21_read(handle, status, 1) != IIC_OK) {
         return AHT21_ERR_IIC;
     }
     return AHT21_OK;
 }
 
+#if !AHT21_COMPACT && !AHT21_LAZY_CONVERT
 /**
   * @brief  Parse raw data
   */
 static void aht21_parse_data(AHT21_Handle* handle)
 {
-    uint32_t humidity_raw, temperature_raw;
+    handle->temperature = aht21_calc_temperature(&handle->raw_data[1]);
+    handle->humidity = aht21_calc_humidity(&handle->raw_data[1]);
+}
+#endif
+
+/**
+  * @brief  Convert temperature from packed codes (frame bytes 1..5)
+  */
+static float aht21_calc_temperature(const uint8_t* raw)
+{
+    // Extract temperature data (20 bits)
+    uint32_t temperature_raw = (((uint32_t)raw[2] & 0x0F) << 16) |
+                               ((uint32_t)raw[3] << 8) |
+                               ((uint32_t)raw[4]);
     
+    return aht21_code_to_temperature((int32_t)temperature_raw);
+}
+
+/**
+  * @brief  Convert humidity from packed codes (frame bytes 1..5)
+  */
+static float aht21_calc_humidity(const uint8_t* raw)
+{
     // Extract humidity data (20 bits)
-    humidity_raw = ((uint32_t)handle->raw_data[1] << 12) |
-                   ((uint32_t)handle->raw_data[2] << 4) |
-                   ((uint32_t)handle->raw_data[3] >> 4);
+    uint32_t humidity_raw = ((uint32_t)raw[0] << 12) |
+                            ((uint32_t)raw[1] << 4) |
+                            ((uint32_t)raw[2] >> 4);
     
-    // Extract temperature data (20 bits)
-    temperature_raw = (((uint32_t)handle->raw_data[3] & 0x0F) << 16) |
-                      ((uint32_t)handle->raw_data[4] << 8) |
-                      ((uint32_t)handle->raw_data[5]);
+    return aht21_code_to_humidity((int32_t)humidity_raw);
+}
+
+/**
+  * @brief  Temperature (°C) from 20-bit code
+  * @note   Signed int converts exactly and vectorizes on more targets
+  */
+static inline float aht21_code_to_temperature(int32_t code)
+{
+    return (code * 200.0f) / 1048576.0f - 50.0f;
+}
+
+/**
+  * @brief  Humidity (%) from 20-bit code
+  */
+static inline float aht21_code_to_humidity(int32_t code)
+{
+    return (code * 100.0f) / 1048576.0f;
+}
+
+/**
+  * @brief  AHT21 CRC8 (polynomial 0x31, init 0xFF)
+  */
+static inline uint8_t aht21_crc8(const uint8_t* data, uint8_t len)
+{
+    uint8_t crc = 0xFF;
+    for (uint8_t i = 0; i < len; i++) {
+        crc = aht21_crc8_table[crc ^ data[i]];
+    }
+    return crc;
+}
+
+#if AHT21_USE_OVERSAMPLING
+/**
+  * @brief  Add last conversion to oversampling accumulators
+  * @retval 1 when the sample is complete, mean codes stored as last sample
+  */
+static uint8_t aht21_os_accumulate(AHT21_Handle* handle)
+{
+    if (handle->os_ratio <= 1) {
+        handle->humi_spread = 0;
+        handle->temp_spread = 0;
+        return 1;
+    }
+    
+    uint32_t humi, temp;
+    aht21_unpack(AHT21_RAW_CODES(handle), &humi, &temp);
+    
+    if (handle->os_count == 0) {
+        handle->os_humi_sum = 0;
+        handle->os_temp_sum = 0;
+        handle->os_humi_min = handle->os_humi_max = humi;
+        handle->os_temp_min = handle->os_temp_max = temp;
+    }
+    
+    handle->os_humi_sum += humi;
+    handle->os_temp_sum += temp;
+    if (humi < handle->os_humi_min) handle->os_humi_min = humi;
+    if (humi > handle->os_humi_max) handle->os_humi_max = humi;
+    if (temp < handle->os_temp_min) handle->os_temp_min = temp;
+    if (temp > handle->os_temp_max) handle->os_temp_max = temp;
+    
+    if (++handle->os_count < handle->os_ratio) return 0;
+    
+    // Rounded mean codes, converted once like a single conversion
+    uint32_t n = handle->os_count;
+    aht21_pack(AHT21_RAW_CODES(handle),
+               (handle->os_humi_sum + n / 2) / n,
+               (handle->os_temp_sum + n / 2) / n);
+    handle->humi_spread = handle->os_humi_max - handle->os_humi_min;
+    handle->temp_spread = handle->os_temp_max - handle->os_temp_min;
+    handle->os_count = 0;
+    return 1;
+}
+
+/**
+  * @brief  Extract 20-bit codes from packed bytes (frame bytes 1..5)
+  */
+static void aht21_unpack(const uint8_t* raw, uint32_t* humi, uint32_t* temp)
+{
+    *humi = ((uint32_t)raw[0] << 12) | ((uint32_t)raw[1] << 4) | ((uint32_t)raw[2] >> 4);
+    *temp = (((uint32_t)raw[2] & 0x0F) << 16) | ((uint32_t)raw[3] << 8) | (uint32_t)raw[4];
+}
+
+/**
+  * @brief  Pack 20-bit codes into frame layout (frame bytes 1..5)
+  */
+static void aht21_pack(uint8_t* raw, uint32_t humi, uint32_t temp)
+{
+    raw[0] = (uint8_t)(humi >> 12);
+    raw[1] = (uint8_t)(humi >> 4);
+    raw[2] = (uint8_t)((humi << 4) | ((temp >> 16) & 0x0F));
+    raw[3] = (uint8_t)(temp >> 8);
+    raw[4] = (uint8_t)temp;
+}
+#endif
+
+#if AHT21_RING_SIZE > 0
+/**
+  * @brief  Store last frame in ring, drop it when ring is full
+  */
+static void aht21_ring_push(AHT21_Handle* handle)
+{
+    uint8_t head = handle->ring_head;
+    uint8_t next = (head + 1 < AHT21_RING_SIZE) ? (head + 1) : 0;
+    
+    if (next == handle->ring_tail) {
+        handle->ring_overrun++;
+        return;
+    }
+    
+    AHT21_RawSample* sample = &handle->ring[head];
+#if AHT21_USE_TIMESTAMPS
+    sample->timestamp = handle->sample_time;
+#endif
+    memcpy(sample->raw, AHT21_RAW_CODES(handle), sizeof(sample->raw));
     
-    // Convert to actual values
-    handle->humidity = (humidity_raw * 100.0f) / 1048576.0f;
-    handle->temperature = (temperature_raw * 200.0f) / 1048576.0f - 50.0f;
+    AHT21_BARRIER();
+    handle->ring_head = next;
 }
+#endif
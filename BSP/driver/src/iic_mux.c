@@ -0,0 +1,58 @@
+/*
+ * IIC Multiplexer Layer Implementation
+ */
+
+#include "iic_mux.h"
+
+/**
+  * @brief  Initialize multiplexer handle
+  * @note   Selection state is unknown until first iic_mux_select()
+  */
+void iic_mux_init(IIC_Mux* mux, IIC_Handle* iic, uint8_t addr)
+{
+    if (!mux || !iic) return;
+    
+    mux->iic = iic;
+    mux->addr = addr;
+    mux->channel = IIC_MUX_NONE;
+}
+
+/**
+  * @brief  Select downstream channel
+  * @note   Control byte is only sent when the channel changes
+  */
+IIC_Result iic_mux_select(IIC_Mux* mux, uint8_t channel)
+{
+    if (!mux || channel >= IIC_MUX_CHANNELS) return IIC_ERR_INVALID_PARAM;
+    if (mux->channel == channel) return IIC_OK;
+    
+    uint8_t ctrl = (uint8_t)(1u << channel);
+    IIC_Result result = iic_write(mux->iic, mux->addr, &ctrl, 1);
+    
+    // On failure the multiplexer state is unknown, force resend next time
+    mux->channel = (result == IIC_OK) ? channel : IIC_MUX_NONE;
+    return result;
+}
+
+/**
+  * @brief  Disconnect all downstream channels
+  */
+IIC_Result iic_mux_disable(IIC_Mux* mux)
+{
+    if (!mux) return IIC_ERR_INVALID_PARAM;
+    
+    uint8_t ctrl = 0x00;
+    IIC_Result result = iic_write(mux->iic, mux->addr, &ctrl, 1);
+    mux->channel = IIC_MUX_NONE;
+    return result;
+}
+
+/**
+  * @brief  Forget cached channel (e.g. after multiplexer reset)
+  */
+void iic_mux_invalidate(IIC_Mux* mux)
+{
+    if (mux) {
+        mux->channel = IIC_MUX_NONE;
+    }
+}